@@ -53,6 +53,10 @@ IECORECYCLES_API ccl::TypeDesc typeFromGeometricDataInterpretation( IECore::Geom
 /// Converts a primitive variable to a ccl::Attribute inside of a ccl::AttributeSet
 IECORECYCLES_API void convertPrimitiveVariable( const std::string &name, const IECoreScene::PrimitiveVariable &primitiveVariable, ccl::AttributeSet &attributes );
 
+/// Replaces the float colour attributes on mesh corners with sRGB encoded
+/// bytes, which take a quarter of the memory. Returns the number of bytes saved.
+IECORECYCLES_API size_t convertColorsToBytes( ccl::AttributeSet &attributes );
+
 } // namespace AttributeAlgo
 
 } // namespace IECoreCycles
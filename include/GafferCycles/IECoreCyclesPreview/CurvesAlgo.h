@@ -55,6 +55,11 @@ IECORECYCLES_API ccl::Object *convert( const IECoreScene::CurvesPrimitive *mesh,
 /// As above, but converting a moving object. If no motion converter
 /// is available, the first sample is converted instead.
 IECORECYCLES_API ccl::Object *convert( const std::vector<const IECoreScene::CurvesPrimitive *> &samples, const std::vector<float> &times, const int frameIdx, const std::string &nodeName, ccl::Scene *scene = nullptr );
+/// As above, but keeping only a random subset of the curves, in the
+/// proportion given by `density`. The remaining curves are widened to
+/// preserve coverage, and the subset is stable from frame to frame.
+IECORECYCLES_API ccl::Object *convert( const IECoreScene::CurvesPrimitive *curve, float density, const std::string &nodeName, ccl::Scene *scene = nullptr );
+IECORECYCLES_API ccl::Object *convert( const std::vector<const IECoreScene::CurvesPrimitive *> &samples, const std::vector<float> &times, const int frameIdx, float density, const std::string &nodeName, ccl::Scene *scene = nullptr );
 
 } // namespace CurvesAlgo
 
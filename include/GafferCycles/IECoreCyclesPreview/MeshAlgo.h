@@ -55,8 +55,17 @@ IECORECYCLES_API ccl::Object *convert( const IECoreScene::MeshPrimitive *mesh, c
 /// As above, but converting a moving object. If no motion converter
 /// is available, the first sample is converted instead.
 IECORECYCLES_API ccl::Object *convert( const std::vector<const IECoreScene::MeshPrimitive *> &samples, const std::vector<float> &times, const int frameIdx, const std::string &nodeName, ccl::Scene *scene = nullptr );
+/// As above, but with control over the generation of normals for meshes
+/// without "N". When `generateNormals` is false, smooth polygon meshes are
+/// converted without normals, leaving Cycles to compute them itself.
+IECORECYCLES_API ccl::Object *convert( const IECoreScene::MeshPrimitive *mesh, bool generateNormals, const std::string &nodeName, ccl::Scene *scene = nullptr );
+IECORECYCLES_API ccl::Object *convert( const std::vector<const IECoreScene::MeshPrimitive *> &samples, const std::vector<float> &times, const int frameIdx, bool generateNormals, const std::string &nodeName, ccl::Scene *scene = nullptr );
 /// Compute tangents.
 IECORECYCLES_API void computeTangents( ccl::Mesh *cmesh, const IECoreScene::MeshPrimitive *mesh, bool needsign );
+/// Compute tangents for the named UV set, storing them as "<uvSet>.tangent",
+/// and as "<uvSet>.tangent_sign" if `needsign` is true. Does nothing if the
+/// mesh has no such UV set.
+IECORECYCLES_API void computeTangents( ccl::Mesh *cmesh, const std::string &uvSet, bool needsign );
 
 } // namespace MeshAlgo
 
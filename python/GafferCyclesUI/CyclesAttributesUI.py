@@ -51,7 +51,7 @@ def __visibilitySummary( plug ) :
 def __renderingSummary( plug ) :
 
 	info = []
-	for childName in ( "useHoldout", "isShadowCatcher", "color", "dupliGenerated", "dupliUV", "lightGroup" ) :
+	for childName in ( "useHoldout", "isShadowCatcher", "autoNormals", "color", "dupliGenerated", "dupliUV", "lightGroup" ) :
 		if plug[childName]["enabled"].getValue() :
 			info.append( IECore.CamelCase.toSpaced( childName ) + ( " On" if plug[childName]["value"].getValue() else " Off" ) )
 
@@ -60,7 +60,7 @@ def __renderingSummary( plug ) :
 def __subdivisionSummary( plug ) :
 
 	info = []
-	for childName in ( "maxLevel", "dicingScale" ) :
+	for childName in ( "maxLevel", "dicingScale", "subdivisionInstancing" ) :
 		if plug[childName]["enabled"].getValue() :
 			info.append( IECore.CamelCase.toSpaced( childName ) + ( " On" if plug[childName]["value"].getValue() else " Off" ) )
 
@@ -245,6 +245,138 @@ Gaffer.Metadata.registerNode(
 
 		],
 
+		"attributes.autoNormals" : [
+
+			"description",
+			"""
+			Leaves the generation of normals for smooth polygon
+			meshes without "N" to Cycles, rather than computing
+			them during scene translation.
+			""",
+
+			"layout:section", "Rendering",
+
+		],
+
+		"attributes.colorPrecision" : [
+
+			"description",
+			"""
+			The precision used to store face-varying colours on
+			meshes. Byte precision stores sRGB encoded 8 bit
+			colours, using a quarter of the memory of float
+			precision.
+			""",
+
+			"layout:section", "Rendering",
+
+		],
+
+		"attributes.colorPrecision.value" : [
+
+			"preset:Float", "float",
+			"preset:Byte", "byte",
+
+			"plugValueWidget:type", "GafferUI.PresetsPlugValueWidget",
+
+		],
+
+		"attributes.curveDensity" : [
+
+			"description",
+			"""
+			The proportion of curves to render, for reducing the
+			cost of distant hair and fur. A random subset of the
+			curves is kept, which is the same from frame to frame,
+			and the remaining curves are widened to preserve their
+			coverage.
+			""",
+
+			"layout:section", "Rendering",
+
+		],
+
+		"attributes.curvesPerPixel" : [
+
+			"description",
+			"""
+			When non-zero, curves are thinned automatically so that
+			there are no more than this many curves per pixel, based
+			on the size of the object's bound as seen by the render
+			camera. This is combined with the Curve Density. The
+			density is chosen when the object is first translated,
+			and is not updated when the camera moves.
+			""",
+
+			"layout:section", "Rendering",
+
+		],
+
+		"attributes.velocityBlur" : [
+
+			"description",
+			"""
+			Renders deformation blur for objects with a single
+			motion sample, by extrapolating their positions over the
+			camera shutter from a "velocity" (or "v") primitive
+			variable, and an optional "accel" primitive variable.
+			This is much cheaper than evaluating the scene at
+			several times, and works for simulations whose topology
+			changes from frame to frame. Objects with several motion
+			samples are unaffected. When the object also has
+			transform blur, positions are extrapolated to the times
+			of the transform samples, because Cycles needs the same
+			number of steps for both.
+			""",
+
+			"layout:section", "Rendering",
+
+		],
+
+		"attributes.velocityScale" : [
+
+			"description",
+			"""
+			Multiplies the velocities used by Velocity Blur.
+			Velocities are assumed to be in units per frame, so
+			per-second velocities should be scaled by 1 / fps.
+			""",
+
+			"layout:section", "Rendering",
+
+		],
+
+		"attributes.motionTolerance" : [
+
+			"description",
+			"""
+			When non-zero, transform and deformation blur samples
+			are dropped where interpolating between the remaining
+			samples reproduces the motion to within this distance
+			in world space. This reduces the memory and render time
+			of objects whose motion is close to linear, and objects
+			that don't move at all are rendered without motion blur.
+			""",
+
+			"layout:section", "Rendering",
+
+		],
+
+		"attributes.motionPixelTolerance" : [
+
+			"description",
+			"""
+			As for Motion Tolerance, but measured in pixels, based on
+			the distance of the object's bound from the render camera.
+			When both are set, the larger tolerance is used. Samples
+			are chosen when the object is first translated, and are
+			not updated when the camera moves.
+			""",
+
+			"layout:section", "Rendering",
+
+		],
+
 		"attributes.color" : [
 
 			"description",
@@ -314,6 +446,22 @@ Gaffer.Metadata.registerNode(
 
 		],
 
+		"attributes.subdivisionInstancing" : [
+
+			"description",
+			"""
+			Allows identical subdivision meshes with the same
+			max level and dicing scale to share a single
+			tessellation. The shared mesh is diced for the
+			instance that is largest as seen from the dicing
+			camera, so more distant instances may be diced
+			more finely than needed.
+			""",
+
+			"layout:section", "Subdivision",
+
+		],
+
 		# Volume
 
 		"attributes.volumeClipping" : [
@@ -61,10 +61,19 @@ CyclesAttributes::CyclesAttributes( const std::string &name )
 	attributes->addChild( new Gaffer::NameValuePlug( "ccl:is_shadow_catcher", new IECore::BoolData( false ), false, "isShadowCatcher" ) );
 	attributes->addChild( new Gaffer::NameValuePlug( "ccl:shadow_terminator_shading_offset", new IECore::FloatData( 0.0f ), false, "shadowTerminatorShadingOffset" ) );
 	attributes->addChild( new Gaffer::NameValuePlug( "ccl:shadow_terminator_geometry_offset", new IECore::FloatData( 0.0f ), false, "shadowTerminatorGeometryOffset" ) );
+	attributes->addChild( new Gaffer::NameValuePlug( "ccl:auto_normals", new IECore::BoolData( false ), false, "autoNormals" ) );
+	attributes->addChild( new Gaffer::NameValuePlug( "ccl:color_precision", new IECore::StringData( "float" ), false, "colorPrecision" ) );
+	attributes->addChild( new Gaffer::NameValuePlug( "ccl:curve_density", new IECore::FloatData( 1.0f ), false, "curveDensity" ) );
+	attributes->addChild( new Gaffer::NameValuePlug( "ccl:curves_per_pixel", new IECore::FloatData( 0.0f ), false, "curvesPerPixel" ) );
+	attributes->addChild( new Gaffer::NameValuePlug( "ccl:velocity_blur", new IECore::BoolData( false ), false, "velocityBlur" ) );
+	attributes->addChild( new Gaffer::NameValuePlug( "ccl:velocity_scale", new IECore::FloatData( 1.0f ), false, "velocityScale" ) );
+	attributes->addChild( new Gaffer::NameValuePlug( "ccl:motion_tolerance", new IECore::FloatData( 0.0f ), false, "motionTolerance" ) );
+	attributes->addChild( new Gaffer::NameValuePlug( "ccl:motion_pixel_tolerance", new IECore::FloatData( 0.0f ), false, "motionPixelTolerance" ) );
 
 	// Subdivision parameters
 	attributes->addChild( new Gaffer::NameValuePlug( "ccl:max_level", new IECore::IntData( 1 ), false, "maxLevel" ) );
 	attributes->addChild( new Gaffer::NameValuePlug( "ccl:dicing_rate", new IECore::FloatData( 1.0f ), false, "dicingScale" ) );
+	attributes->addChild( new Gaffer::NameValuePlug( "ccl:subdivision_instancing", new IECore::BoolData( false ), false, "subdivisionInstancing" ) );
 
 	// Color
 	attributes->addChild( new Gaffer::NameValuePlug( "Cs", new IECore::Color3fData( Imath::Color3f( 0.0f ) ), false, "color" ) );
@@ -36,11 +36,19 @@
 #include "GafferCycles/IECoreCyclesPreview/ObjectAlgo.h"
 #include "GafferCycles/IECoreCyclesPreview/SocketAlgo.h"
 
+#include "PackingAlgo.h"
+
 #include "IECore/SimpleTypedData.h"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include <atomic>
+
 // Cycles
 #include "kernel/types.h"
 #include "scene/mesh.h"
+#include "util/color.h"
 #include "util/param.h"
 #include "util/types.h"
 
@@ -52,6 +60,66 @@ using namespace IECoreCycles;
 
 namespace
 {
+
+// Converts each element of `source` into `destination`, which has room
+// for `size` elements, in parallel. If `indices` are given, they are
+// expanded as we go, so indexed data never needs expanding upstream.
+// Returns false if the data doesn't match the size of the destination
+// or an index is out of range.
+template<typename Source, typename Destination, typename Converter>
+bool convertVector( const std::vector<Source> &source, const IntVectorData *indices, Destination *destination, size_t size, Converter &&converter )
+{
+	if( ( indices ? indices->readable().size() : source.size() ) != size )
+	{
+		return false;
+	}
+
+	const int *i = indices ? indices->readable().data() : nullptr;
+	std::atomic<bool> valid( true );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, size ),
+		[&]( const tbb::blocked_range<size_t> &r ) {
+			for( size_t j = r.begin(); j != r.end(); ++j )
+			{
+				const size_t k = i ? i[j] : j;
+				if( k >= source.size() )
+				{
+					valid = false;
+					continue;
+				}
+				destination[j] = converter( source[k] );
+			}
+		}
+	);
+
+	return valid;
+}
+
+// As above, but copying unindexed data with the vectorised kernels
+// from PackingAlgo.
+template<typename Source, typename Destination, typename Converter>
+bool packVector( const std::vector<Source> &source, const IntVectorData *indices, Destination *destination, size_t size, Converter &&converter )
+{
+	if( indices || source.size() != size )
+	{
+		return convertVector( source, indices, destination, size, converter );
+	}
+
+	PackingAlgo::pack( source.data(), destination, size );
+	return true;
+}
+
+size_t numElements( const ccl::Attribute *attr )
+{
+	return attr->buffer.size() / attr->data_sizeof();
+}
+
+void removeInvalid( const std::string &name, ccl::Attribute *attr, ccl::AttributeSet &attributes )
+{
+	msg( Msg::Warning, "IECoreCyles::AttributeAlgo::convertPrimitiveVariable", boost::format( "Variable \"%s\" has invalid size or indices - not converting." ) % name );
+	attributes.remove( attr );
+}
+
 } // namespace
 
 //////////////////////////////////////////////////////////////////////////
@@ -75,8 +143,9 @@ ccl::TypeDesc typeDesc( IECore::TypeId dataType )
 		case IntDataTypeId:
 			return ccl::TypeDesc::TypeFloat;
 		case Color3fVectorDataTypeId :
-		case Color4fVectorDataTypeId :
 			return ccl::TypeDesc::TypeColor;
+		case Color4fVectorDataTypeId :
+			return ccl::TypeRGBA;
 		case V2fVectorDataTypeId :
 		case V2iVectorDataTypeId :
 			return ccl::TypeFloat2;
@@ -174,10 +243,36 @@ void convertPrimitiveVariable( const std::string &name, const IECoreScene::Primi
 				break;
 			case PrimitiveVariable::Varying :
 			case PrimitiveVariable::FaceVarying :
-				celem = ccl::ATTR_ELEMENT_CORNER;
+				if( attributes.geometry->geometry_type == ccl::Geometry::HAIR )
+				{
+					// `CurvesAlgo` expands varying values to one per key
+					// before they get here, and `convertVector()` verifies
+					// that they match.
+					celem = ccl::ATTR_ELEMENT_CURVE_KEY;
+				}
+				else if( attributes.geometry->geometry_type == ccl::Geometry::POINTCLOUD )
+				{
+					celem = ccl::ATTR_ELEMENT_VERTEX;
+				}
+				else
+				{
+					celem = ccl::ATTR_ELEMENT_CORNER;
+				}
 				break;
 			case PrimitiveVariable::Uniform :
-				celem = ccl::ATTR_ELEMENT_FACE;
+				if( attributes.geometry->geometry_type == ccl::Geometry::HAIR )
+				{
+					celem = ccl::ATTR_ELEMENT_CURVE;
+				}
+				else if( attributes.geometry->geometry_type == ccl::Geometry::POINTCLOUD )
+				{
+					// Points have a single uniform value.
+					celem = ccl::ATTR_ELEMENT_MESH;
+				}
+				else
+				{
+					celem = ccl::ATTR_ELEMENT_FACE;
+				}
 				break;
 			default :
 				break;
@@ -195,14 +290,14 @@ void convertPrimitiveVariable( const std::string &name, const IECoreScene::Primi
 		{
 			const std::vector<float> &floatData = data->readable();
 
-			size_t num = floatData.size();
 			float *cdata = attr->data_float();
 
 			if( cdata )
 			{
-				for( size_t i = 0; i < num; ++i )
-					*(cdata++) = floatData[i];
-				cdata = attr->data_float();
+				if( !packVector( floatData, primitiveVariable.indices.get(), cdata, numElements( attr ), []( const float &f ) { return f; } ) )
+				{
+					removeInvalid( name, attr, attributes );
+				}
 				return;
 			}
 		}
@@ -211,14 +306,14 @@ void convertPrimitiveVariable( const std::string &name, const IECoreScene::Primi
 		{
 			const std::vector<int> &intData = data->readable();
 
-			size_t num = intData.size();
 			float *cdata = attr->data_float();
 
 			if( cdata )
 			{
-				for( size_t i = 0; i < num; ++i )
-					*(cdata++) = (float)intData[i];
-				cdata = attr->data_float();
+				if( !packVector( intData, primitiveVariable.indices.get(), cdata, numElements( attr ), []( const int &i ) { return (float)i; } ) )
+				{
+					removeInvalid( name, attr, attributes );
+				}
 				return;
 			}
 		}
@@ -232,14 +327,14 @@ void convertPrimitiveVariable( const std::string &name, const IECoreScene::Primi
 		if( const V3fVectorData *data = runTimeCast<const V3fVectorData>( primitiveVariable.data.get() ) )
 		{
 			const std::vector<V3f> &v3fData = data->readable();
-			size_t num = v3fData.size();
 			ccl::float3 *cdata = attr->data_float3();
 
 			if( cdata )
 			{
-				for( size_t i = 0; i < num; ++i )
-					*(cdata++) = ccl::make_float3( v3fData[i].x, v3fData[i].y, v3fData[i].z );
-				cdata = attr->data_float3();
+				if( !packVector( v3fData, primitiveVariable.indices.get(), cdata, numElements( attr ), []( const V3f &v ) { return ccl::make_float3( v.x, v.y, v.z ); } ) )
+				{
+					removeInvalid( name, attr, attributes );
+				}
 				return;
 			}
 		}
@@ -247,14 +342,14 @@ void convertPrimitiveVariable( const std::string &name, const IECoreScene::Primi
 		if( const V3iVectorData *data = runTimeCast<const V3iVectorData>( primitiveVariable.data.get() ) )
 		{
 			const std::vector<V3i> &v3iData = data->readable();
-			size_t num = v3iData.size();
 			ccl::float3 *cdata = attr->data_float3();
 
 			if( cdata )
 			{
-				for( size_t i = 0; i < num; ++i )
-					*(cdata++) = ccl::make_float3( (float)v3iData[i].x, (float)v3iData[i].y, (float)v3iData[i].z );
-				cdata = attr->data_float3();
+				if( !convertVector( v3iData, primitiveVariable.indices.get(), cdata, numElements( attr ), []( const V3i &v ) { return ccl::make_float3( (float)v.x, (float)v.y, (float)v.z ); } ) )
+				{
+					removeInvalid( name, attr, attributes );
+				}
 				return;
 			}
 		}
@@ -262,14 +357,14 @@ void convertPrimitiveVariable( const std::string &name, const IECoreScene::Primi
 		if( const V2fVectorData *data = runTimeCast<const V2fVectorData>( primitiveVariable.data.get() ) )
 		{
 			const std::vector<V2f> &v2fData = data->readable();
-			size_t num = v2fData.size();
 			ccl::float2 *cdata = attr->data_float2();
 
 			if( cdata )
 			{
-				for( size_t i = 0; i < num; ++i )
-					*(cdata++) = ccl::make_float2( v2fData[i].x, v2fData[i].y );
-				cdata = attr->data_float2();
+				if( !convertVector( v2fData, primitiveVariable.indices.get(), cdata, numElements( attr ), []( const V2f &v ) { return ccl::make_float2( v.x, v.y ); } ) )
+				{
+					removeInvalid( name, attr, attributes );
+				}
 				return;
 			}
 		}
@@ -277,14 +372,14 @@ void convertPrimitiveVariable( const std::string &name, const IECoreScene::Primi
 		if( const V2iVectorData *data = runTimeCast<const V2iVectorData>( primitiveVariable.data.get() ) )
 		{
 			const std::vector<V2i> &v2iData = data->readable();
-			size_t num = v2iData.size();
 			ccl::float2 *cdata = attr->data_float2();
 
 			if( cdata )
 			{
-				for( size_t i = 0; i < num; ++i )
-					*(cdata++) = ccl::make_float2( (float)v2iData[i].x, (float)v2iData[i].y );
-				cdata = attr->data_float2();
+				if( !convertVector( v2iData, primitiveVariable.indices.get(), cdata, numElements( attr ), []( const V2i &v ) { return ccl::make_float2( (float)v.x, (float)v.y ); } ) )
+				{
+					removeInvalid( name, attr, attributes );
+				}
 				return;
 			}
 		}
@@ -292,19 +387,34 @@ void convertPrimitiveVariable( const std::string &name, const IECoreScene::Primi
 		if( const Color3fVectorData *data = runTimeCast<const Color3fVectorData>( primitiveVariable.data.get() ) )
 		{
 			const std::vector<Color3f> &colorData = data->readable();
-			size_t num = colorData.size();
 			ccl::float3 *cdata = attr->data_float3();
 
 			if( cdata )
 			{
-				for( size_t i = 0; i < num; ++i )
-					*(cdata++) = ccl::make_float3( colorData[i].x, colorData[i].y, colorData[i].z );
-				cdata = attr->data_float3();
+				if( !packVector( colorData, primitiveVariable.indices.get(), cdata, numElements( attr ), []( const Color3f &c ) { return ccl::make_float3( c.x, c.y, c.z ); } ) )
+				{
+					removeInvalid( name, attr, attributes );
+				}
+				return;
+			}
+		}
+
+		if( const Color4fVectorData *data = runTimeCast<const Color4fVectorData>( primitiveVariable.data.get() ) )
+		{
+			const std::vector<Color4f> &colorData = data->readable();
+			ccl::float4 *cdata = attr->data_float4();
+
+			if( cdata )
+			{
+				if( !packVector( colorData, primitiveVariable.indices.get(), cdata, numElements( attr ), []( const Color4f &c ) { return ccl::make_float4( c.r, c.g, c.b, c.a ); } ) )
+				{
+					removeInvalid( name, attr, attributes );
+				}
 				return;
 			}
 		}
 
-		msg( Msg::Warning, "IECoreCyles::AttributeAlgo::convertPrimitiveVariable", boost::format( "Variable \"%s\" has unsupported type \"%s\" (expected V3fVectorData, Color3fVectorData or V2fVectorData)." ) % name % primitiveVariable.data->typeName() );
+		msg( Msg::Warning, "IECoreCyles::AttributeAlgo::convertPrimitiveVariable", boost::format( "Variable \"%s\" has unsupported type \"%s\" (expected V3fVectorData, Color3fVectorData, Color4fVectorData or V2fVectorData)." ) % name % primitiveVariable.data->typeName() );
 		attributes.remove( attr );
 		return;
 	}
@@ -412,6 +522,51 @@ void convertPrimitiveVariable( const std::string &name, const IECoreScene::Primi
 	}
 }
 
+size_t convertColorsToBytes( ccl::AttributeSet &attributes )
+{
+	std::vector<ccl::Attribute *> colors;
+	for( ccl::Attribute &attr : attributes.attributes )
+	{
+		if(
+			attr.element == ccl::ATTR_ELEMENT_CORNER && attr.std == ccl::ATTR_STD_NONE &&
+			( attr.type == ccl::TypeDesc::TypeColor || attr.type == ccl::TypeRGBA )
+		)
+		{
+			colors.push_back( &attr );
+		}
+	}
+
+	size_t saved = 0;
+	for( ccl::Attribute *attr : colors )
+	{
+		// Rename the float attribute, so that the byte attribute can
+		// take its place while we read from it.
+		const ccl::ustring name = attr->name;
+		attr->name = ccl::ustring( ( name.string() + ".float" ).c_str() );
+		ccl::Attribute *byteAttr = attributes.add( name, ccl::TypeRGBA, ccl::ATTR_ELEMENT_CORNER_BYTE );
+
+		// Cycles decodes byte colours from sRGB when it reads them.
+		const ccl::float3 *color3 = attr->type == ccl::TypeDesc::TypeColor ? attr->data_float3() : nullptr;
+		const ccl::float4 *color4 = attr->type == ccl::TypeRGBA ? attr->data_float4() : nullptr;
+		ccl::uchar4 *cdata = byteAttr->data_uchar4();
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, std::min( numElements( attr ), numElements( byteAttr ) ) ),
+			[&]( const tbb::blocked_range<size_t> &r ) {
+				for( size_t i = r.begin(); i != r.end(); ++i )
+				{
+					const ccl::float4 c = color4 ? color4[i] : ccl::make_float4( color3[i].x, color3[i].y, color3[i].z, 1.0f );
+					cdata[i] = ccl::color_float4_to_uchar4( ccl::color_linear_to_srgb_v4( c ) );
+				}
+			}
+		);
+
+		saved += attr->buffer.size() - byteAttr->buffer.size();
+		attributes.remove( attr );
+	}
+
+	return saved;
+}
+
 } // AttributeAlgo
 
 } // IECoreCycles
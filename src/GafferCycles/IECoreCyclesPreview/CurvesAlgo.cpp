@@ -37,15 +37,24 @@
 #include "GafferCycles/IECoreCyclesPreview/AttributeAlgo.h"
 #include "GafferCycles/IECoreCyclesPreview/ObjectAlgo.h"
 
+#include "PackingAlgo.h"
+
 #include "IECoreScene/CurvesPrimitive.h"
 
-#include "IECore/Interpolator.h"
+#include "IECore/DataAlgo.h"
 #include "IECore/MessageHandler.h"
 #include "IECore/SimpleTypedData.h"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include <algorithm>
+#include <memory>
+
 // Cycles
 #include "scene/geometry.h"
 #include "scene/hair.h"
+#include "util/hash.h"
 
 using namespace std;
 using namespace Imath;
@@ -56,37 +65,431 @@ using namespace IECoreCycles;
 namespace
 {
 
-ccl::Hair *convertCommon( const IECoreScene::CurvesPrimitive *curve )
+//////////////////////////////////////////////////////////////////////////
+// Basis conversion
+//////////////////////////////////////////////////////////////////////////
+
+// Cycles interpolates curve keys with Catmull-Rom splines. B-spline and
+// Bezier curves are converted by sampling them at each knot, and at the
+// middle of each Bezier segment, so that the keys lie on the original
+// curve. Other curves are passed through unchanged, as are periodic
+// curves, which Cycles has no equivalent for.
+//
+// When `density` is less than 1, a random subset of the curves is kept.
+// The choice depends only on the index of each curve, so is stable from
+// frame to frame, and the curves kept at any density are a superset of
+// those kept at lower densities.
+class KeyResampler
+{
+
+	public :
+
+		KeyResampler( const IECoreScene::CurvesPrimitive *curve, float density = 1.0f )
+			:	m_verticesPerCurve( curve->verticesPerCurve()->readable() ),
+				m_basis( curve->periodic() ? StandardCubicBasis::Unknown : curve->basis().standardBasis() ),
+				m_linear( curve->basis() == CubicBasisf::linear() ), m_step( curve->basis().step ), m_periodic( curve->periodic() ),
+				m_numVertices( 0 ), m_numVarying( 0 ), m_thinned( density < 1.0f )
+		{
+			const size_t numSourceCurves = m_verticesPerCurve.size();
+			if( !m_thinned )
+			{
+				m_vertexOffsets.reserve( numSourceCurves + 1 );
+				m_varyingOffsets.reserve( numSourceCurves + 1 );
+				m_keyOffsets.reserve( numSourceCurves + 1 );
+			}
+
+			size_t key = 0;
+			for( size_t i = 0; i < numSourceCurves; ++i )
+			{
+				const int n = m_verticesPerCurve[i];
+				if( !m_thinned || ccl::hash_uint_to_float( i ) < density )
+				{
+					if( m_thinned )
+					{
+						m_sourceCurves.push_back( i );
+					}
+					m_vertexOffsets.push_back( m_numVertices );
+					m_varyingOffsets.push_back( m_numVarying );
+					m_keyOffsets.push_back( key );
+					key += numKeys( n );
+				}
+				m_numVertices += n;
+				m_numVarying += numVarying( n );
+			}
+			m_keyOffsets.push_back( key );
+		}
+
+		size_t numCurves() const
+		{
+			return m_keyOffsets.size() - 1;
+		}
+
+		size_t numSourceCurves() const
+		{
+			return m_verticesPerCurve.size();
+		}
+
+		size_t numVertices() const
+		{
+			return m_numVertices;
+		}
+
+		size_t numVarying() const
+		{
+			return m_numVarying;
+		}
+
+		size_t numKeys() const
+		{
+			return m_keyOffsets.back();
+		}
+
+		size_t firstKey( size_t curve ) const
+		{
+			return m_keyOffsets[curve];
+		}
+
+		// True if curves have been removed.
+		bool thinned() const
+		{
+			return m_thinned;
+		}
+
+		// The factor to widen the remaining curves by, so that they
+		// cover about as much of the image as the original curves.
+		float widthScale() const
+		{
+			return m_thinned && numCurves() ? (float)numSourceCurves() / (float)numCurves() : 1.0f;
+		}
+
+		// True if every vertex maps directly onto a key.
+		bool identity() const
+		{
+			return !m_thinned && numKeys() == numVertices();
+		}
+
+		// True if every varying value maps directly onto a key. There are
+		// never more varying values than keys, so equal totals mean equal
+		// counts for every curve.
+		bool varyingIdentity() const
+		{
+			return !m_thinned && numKeys() == numVarying();
+		}
+
+		// Calls `write( key, value )` for every key, where the values
+		// are computed from the vertex values given by `read( vertex )`.
+		template<typename Reader, typename Writer>
+		void resampleVertex( Reader &&read, Writer &&write ) const
+		{
+			parallelForCurves(
+				[&]( size_t curve ) {
+					const int n = m_verticesPerCurve[sourceCurve( curve )];
+					const size_t v = m_vertexOffsets[curve];
+					size_t k = m_keyOffsets[curve];
+					switch( curveBasis( n ) )
+					{
+						case StandardCubicBasis::BSpline :
+							for( int j = 0; j < n - 2; ++j )
+							{
+								write( k++, ( read( v + j ) + read( v + j + 1 ) * 4.0f + read( v + j + 2 ) ) / 6.0f );
+							}
+							break;
+						case StandardCubicBasis::Bezier :
+							for( int j = 0; j + 3 < n; j += 3 )
+							{
+								write( k++, read( v + j ) );
+								write( k++, ( read( v + j ) + ( read( v + j + 1 ) + read( v + j + 2 ) ) * 3.0f + read( v + j + 3 ) ) / 8.0f );
+							}
+							write( k, read( v + n - 1 ) );
+							break;
+						default :
+							for( int j = 0; j < n; ++j )
+							{
+								write( k++, read( v + j ) );
+							}
+					}
+				}
+			);
+		}
+
+		// As above, but for varying values, of which there is one per
+		// segment boundary. Curves passed through unchanged have a key per
+		// vertex, so for cubic curves the first and last varying values
+		// are repeated to cover the end vertices.
+		template<typename Reader, typename Writer>
+		void resampleVarying( Reader &&read, Writer &&write ) const
+		{
+			parallelForCurves(
+				[&]( size_t curve ) {
+					const int vertices = m_verticesPerCurve[sourceCurve( curve )];
+					const size_t v = m_varyingOffsets[curve];
+					const size_t n = numVarying( vertices );
+					size_t k = m_keyOffsets[curve];
+					if( curveBasis( vertices ) == StandardCubicBasis::Bezier )
+					{
+						for( size_t j = 0; j + 1 < n; ++j )
+						{
+							write( k++, read( v + j ) );
+							write( k++, ( read( v + j ) + read( v + j + 1 ) ) * 0.5f );
+						}
+						write( k, read( v + n - 1 ) );
+					}
+					else if( curveBasis( vertices ) == StandardCubicBasis::BSpline || n == (size_t)vertices )
+					{
+						for( size_t j = 0; j < n; ++j )
+						{
+							write( k++, read( v + j ) );
+						}
+					}
+					else if( n )
+					{
+						const size_t lead = ( vertices - n ) / 2;
+						for( size_t j = 0; j < (size_t)vertices; ++j )
+						{
+							write( k++, read( v + std::min( n - 1, j > lead ? j - lead : 0 ) ) );
+						}
+					}
+				}
+			);
+		}
+
+		// As above, but for uniform values, of which there is one per
+		// curve.
+		template<typename Reader, typename Writer>
+		void resampleUniform( Reader &&read, Writer &&write ) const
+		{
+			parallelForCurves(
+				[&]( size_t curve ) {
+					write( curve, read( sourceCurve( curve ) ) );
+				}
+			);
+		}
+
+	private :
+
+		size_t sourceCurve( size_t curve ) const
+		{
+			return m_thinned ? m_sourceCurves[curve] : curve;
+		}
+
+		// The basis to convert a curve with `n` vertices from, falling
+		// back to passing through curves too short to convert.
+		StandardCubicBasis curveBasis( int n ) const
+		{
+			switch( m_basis )
+			{
+				case StandardCubicBasis::BSpline :
+					return n >= 4 ? m_basis : StandardCubicBasis::Unknown;
+				case StandardCubicBasis::Bezier :
+					return n >= 4 && ( n - 1 ) % 3 == 0 ? m_basis : StandardCubicBasis::Unknown;
+				default :
+					return StandardCubicBasis::Unknown;
+			}
+		}
+
+		size_t numKeys( int n ) const
+		{
+			switch( curveBasis( n ) )
+			{
+				case StandardCubicBasis::BSpline :
+					return n - 2;
+				case StandardCubicBasis::Bezier :
+					return ( ( n - 1 ) / 3 ) * 2 + 1;
+				default :
+					return n;
+			}
+		}
+
+		// The number of varying values for a source curve with `n`
+		// vertices, matching `CurvesPrimitive::variableSize()`.
+		size_t numVarying( int n ) const
+		{
+			int segments;
+			if( m_linear )
+			{
+				segments = m_periodic ? n : n - 1;
+			}
+			else
+			{
+				segments = m_periodic ? n / m_step : ( n - 4 ) / m_step + 1;
+			}
+			return std::max( 0, m_periodic ? segments : segments + 1 );
+		}
+
+		template<typename F>
+		void parallelForCurves( F &&f ) const
+		{
+			tbb::parallel_for(
+				tbb::blocked_range<size_t>( 0, numCurves() ),
+				[&]( const tbb::blocked_range<size_t> &r ) {
+					for( size_t i = r.begin(); i != r.end(); ++i )
+					{
+						f( i );
+					}
+				}
+			);
+		}
+
+		const vector<int> &m_verticesPerCurve;
+		const StandardCubicBasis m_basis;
+		const bool m_linear;
+		const int m_step;
+		const bool m_periodic;
+		size_t m_numVertices;
+		size_t m_numVarying;
+		const bool m_thinned;
+		// Per output curve.
+		vector<size_t> m_sourceCurves;
+		vector<size_t> m_vertexOffsets;
+		vector<size_t> m_varyingOffsets;
+		vector<size_t> m_keyOffsets;
+
+};
+
+// Resamples a vertex, varying or uniform primitive variable to match
+// the keys and curves. Returns null for unsupported types or invalid data.
+template<typename DataType>
+DataPtr resampleData( const KeyResampler &resampler, const PrimitiveVariable &primitiveVariable )
+{
+	const DataType *data = static_cast<const DataType *>( primitiveVariable.data.get() );
+	const auto &values = data->readable();
+	const int *indices = primitiveVariable.indices ? primitiveVariable.indices->readable().data() : nullptr;
+
+	size_t size = resampler.numSourceCurves();
+	size_t resampledSize = resampler.numCurves();
+	if( primitiveVariable.interpolation != PrimitiveVariable::Uniform )
+	{
+		size = primitiveVariable.interpolation == PrimitiveVariable::Vertex ? resampler.numVertices() : resampler.numVarying();
+		resampledSize = resampler.numKeys();
+	}
+
+	if( ( indices ? primitiveVariable.indices->readable().size() : values.size() ) != size )
+	{
+		return nullptr;
+	}
+	if( indices && std::any_of( indices, indices + size, [&]( int i ) { return i < 0 || (size_t)i >= values.size(); } ) )
+	{
+		return nullptr;
+	}
+
+	typename DataType::Ptr result = new DataType;
+	result->writable().resize( resampledSize );
+	auto *out = result->writable().data();
+	setGeometricInterpretation( result.get(), getGeometricInterpretation( data ) );
+
+	auto read = [&]( size_t i ) { return values[indices ? indices[i] : i]; };
+	auto write = [&]( size_t k, const typename DataType::ValueType::value_type &value ) { out[k] = value; };
+	switch( primitiveVariable.interpolation )
+	{
+		case PrimitiveVariable::Vertex :
+			resampler.resampleVertex( read, write );
+			break;
+		case PrimitiveVariable::Varying :
+		case PrimitiveVariable::FaceVarying :
+			resampler.resampleVarying( read, write );
+			break;
+		default :
+			resampler.resampleUniform( read, write );
+	}
+
+	return result;
+}
+
+DataPtr resampleData( const KeyResampler &resampler, const PrimitiveVariable &primitiveVariable )
+{
+	switch( primitiveVariable.data->typeId() )
+	{
+		case FloatVectorDataTypeId :
+			return resampleData<FloatVectorData>( resampler, primitiveVariable );
+		case V2fVectorDataTypeId :
+			return resampleData<V2fVectorData>( resampler, primitiveVariable );
+		case V3fVectorDataTypeId :
+			return resampleData<V3fVectorData>( resampler, primitiveVariable );
+		case Color3fVectorDataTypeId :
+			return resampleData<Color3fVectorData>( resampler, primitiveVariable );
+		case Color4fVectorDataTypeId :
+			return resampleData<Color4fVectorData>( resampler, primitiveVariable );
+		default :
+			return nullptr;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Conversion
+//////////////////////////////////////////////////////////////////////////
+
+// A motion sample. When the second primitive is given, the sample is
+// interpolated halfway between the two as it is written to Cycles,
+// rather than being built as an interpolated copy of the primitive.
+typedef std::pair<const IECoreScene::CurvesPrimitive *, const IECoreScene::CurvesPrimitive *> MotionSample;
+
+// Calls `write( key, position )` for every key.
+template<typename Writer>
+void resampleKeys( const KeyResampler &resampler, const vector<V3f> &p1, const vector<V3f> *p2, Writer &&write )
+{
+	if( p2 )
+	{
+		resampler.resampleVertex( [&]( size_t v ) { return ( p1[v] + (*p2)[v] ) * 0.5f; }, write );
+	}
+	else
+	{
+		resampler.resampleVertex( [&]( size_t v ) { return p1[v]; }, write );
+	}
+}
+
+void writeKeys( const KeyResampler &resampler, const vector<V3f> &p1, const vector<V3f> *p2, ccl::float3 *out )
+{
+	if( !resampler.identity() )
+	{
+		resampleKeys( resampler, p1, p2, [out]( size_t k, const V3f &p ) { out[k] = ccl::make_float3( p.x, p.y, p.z ); } );
+	}
+	else if( p2 )
+	{
+		PackingAlgo::packAverage( p1.data(), p2->data(), out, p1.size() );
+	}
+	else
+	{
+		PackingAlgo::pack( p1.data(), out, p1.size() );
+	}
+}
+
+// Cycles stores the radius in the fourth component of motion keys.
+void writeMotionKeys( const KeyResampler &resampler, const vector<V3f> &p1, const vector<V3f> *p2, const float *radius, ccl::float4 *out )
+{
+	resampleKeys( resampler, p1, p2, [out, radius]( size_t k, const V3f &p ) { out[k] = ccl::make_float4( p.x, p.y, p.z, radius[k] ); } );
+}
+
+ccl::Hair *convertCommon( const IECoreScene::CurvesPrimitive *curve, const KeyResampler &resampler )
 {
 	assert( curve->typeId() == IECoreScene::CurvesPrimitive::staticTypeId() );
 	ccl::Hair *hair = new ccl::Hair();
 
-	size_t numCurves = curve->numCurves();
-	size_t numKeys = 0;
-
-	const IntVectorData *v = curve->verticesPerCurve();
-	const vector<int> &verticesPerCurve = curve->verticesPerCurve()->readable();
-	for( int i = 0; i < verticesPerCurve.size(); ++i )
-		numKeys += verticesPerCurve[i];
+	// Size everything once, so that curves and keys can be filled in
+	// parallel rather than appended one at a time.
+	hair->resize_curves( resampler.numCurves(), resampler.numKeys() );
 
-	hair->reserve_curves( numCurves, numKeys );
+	int *firstKey = hair->get_curve_first_key().data();
+	int *shader = hair->get_curve_shader().data();
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, resampler.numCurves() ),
+		[&]( const tbb::blocked_range<size_t> &r ) {
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				firstKey[i] = resampler.firstKey( i );
+				shader[i] = 0;
+			}
+		}
+	);
 
 	const V3fVectorData *p = curve->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
-	const vector<Imath::V3f> &points = p->readable();
+	writeKeys( resampler, p->readable(), nullptr, hair->get_curve_keys().data() );
 
+	float *radius = hair->get_curve_radius().data();
+	const float radiusScale = resampler.widthScale() / 2.0f;
 	if( const FloatVectorData *w = curve->variableData<FloatVectorData>( "width", PrimitiveVariable::Vertex ) )
 	{
 		const vector<float> &width = w->readable();
-
-		size_t key = 0;
-		for( size_t i = 0; i < numCurves; ++i )
-		{
-			size_t firstKey = key;
-			for( size_t j = 0; j < verticesPerCurve[i]; ++j, ++key )
-				hair->add_curve_key( ccl::make_float3( points[key].x, points[key].y, points[key].z ), width[key] / 2.0f );
-
-			hair->add_curve( firstKey, 0 );
-		}
+		resampler.resampleVertex( [&]( size_t v ) { return width[v]; }, [radius, radiusScale]( size_t k, float value ) { radius[k] = value * radiusScale; } );
 	}
 	else
 	{
@@ -97,17 +500,14 @@ ccl::Hair *convertCommon( const IECoreScene::CurvesPrimitive *curve )
 			constantWidth = cw->readable();
 		}
 
-		size_t key = 0;
-		for( size_t i = 0; i < numCurves; ++i )
-		{
-			size_t firstKey = key;
-			for( size_t j = 0; j < verticesPerCurve[i]; ++j, ++key )
-				hair->add_curve_key( ccl::make_float3( points[key].x, points[key].y, points[key].z ), constantWidth / 2.0f );
-
-			hair->add_curve( firstKey, 0 );
-		}
+		std::fill( radius, radius + resampler.numKeys(), constantWidth * radiusScale );
 	}
 
+	hair->tag_curve_keys_modified();
+	hair->tag_curve_radius_modified();
+	hair->tag_curve_first_key_modified();
+	hair->tag_curve_shader_modified();
+
 	// Convert primitive variables.
 	PrimitiveVariableMap variablesToConvert = curve->variables;
 	variablesToConvert.erase( "P" );
@@ -115,6 +515,19 @@ ccl::Hair *convertCommon( const IECoreScene::CurvesPrimitive *curve )
 
 	for( PrimitiveVariableMap::iterator it = variablesToConvert.begin(), eIt = variablesToConvert.end(); it != eIt; ++it )
 	{
+		const PrimitiveVariable::Interpolation interpolation = it->second.interpolation;
+		if(
+			( !resampler.identity() && interpolation == PrimitiveVariable::Vertex ) ||
+			( !resampler.varyingIdentity() && ( interpolation == PrimitiveVariable::Varying || interpolation == PrimitiveVariable::FaceVarying ) ) ||
+			( resampler.thinned() && interpolation == PrimitiveVariable::Uniform )
+		)
+		{
+			if( DataPtr data = resampleData( resampler, it->second ) )
+			{
+				AttributeAlgo::convertPrimitiveVariable( it->first, PrimitiveVariable( interpolation, data ), hair->attributes );
+				continue;
+			}
+		}
 		AttributeAlgo::convertPrimitiveVariable( it->first, it->second, hair->attributes );
 	}
 	return hair;
@@ -137,36 +550,43 @@ namespace CurvesAlgo
 {
 
 ccl::Object *convert( const IECoreScene::CurvesPrimitive *curve, const std::string &nodeName, ccl::Scene *scene )
+{
+	return convert( curve, 1.0f, nodeName, scene );
+}
+
+ccl::Object *convert( const vector<const IECoreScene::CurvesPrimitive *> &curves, const std::vector<float> &times, const int frameIdx, const std::string &nodeName, ccl::Scene *scene )
+{
+	return convert( curves, times, frameIdx, 1.0f, nodeName, scene );
+}
+
+ccl::Object *convert( const IECoreScene::CurvesPrimitive *curve, float density, const std::string &nodeName, ccl::Scene *scene )
 {
 	ccl::Object *cobject = new ccl::Object();
-	cobject->set_geometry( convertCommon( curve ) );
+	cobject->set_geometry( convertCommon( curve, KeyResampler( curve, density ) ) );
 	cobject->name = ccl::ustring(nodeName.c_str());
 	return cobject;
 }
 
-ccl::Object *convert( const vector<const IECoreScene::CurvesPrimitive *> &curves, const std::vector<float> &times, const int frameIdx, const std::string &nodeName, ccl::Scene *scene )
+ccl::Object *convert( const vector<const IECoreScene::CurvesPrimitive *> &curves, const std::vector<float> &times, const int frameIdx, float density, const std::string &nodeName, ccl::Scene *scene )
 {
 	const int numSamples = curves.size();
 
 	ccl::Hair *hair = nullptr;
-	std::vector<const IECoreScene::CurvesPrimitive *> samples;
-	IECoreScene::CurvesPrimitivePtr midMesh;
+	std::unique_ptr<KeyResampler> resampler;
+	std::vector<MotionSample> samples;
 
 	if( frameIdx != -1 ) // Start/End frames
 	{
-		hair = convertCommon(curves[frameIdx]);
+		resampler.reset( new KeyResampler( curves[frameIdx], density ) );
+		hair = convertCommon( curves[frameIdx], *resampler );
 
 		if( numSamples == 2 ) // Make sure we have 3 samples
 		{
 			const V3fVectorData *p1 = curves[0]->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
 			const V3fVectorData *p2 = curves[1]->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
-			if( p1 && p2 )
+			if( p1 && p2 && p1->readable().size() == p2->readable().size() )
 			{
-				midMesh = curves[frameIdx]->copy();
-				V3fVectorData *midP = midMesh->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
-				IECore::LinearInterpolator<std::vector<V3f>>()( p1->readable(), p2->readable(), 0.5f, midP->writable() );
-
-				samples.push_back( midMesh.get() );
+				samples.push_back( MotionSample( curves[0], curves[1] ) );
 			}
 		}
 
@@ -174,19 +594,20 @@ ccl::Object *convert( const vector<const IECoreScene::CurvesPrimitive *> &curves
 		{
 			if( i == frameIdx )
 				continue;
-			samples.push_back( curves[i] );
+			samples.push_back( MotionSample( curves[i], nullptr ) );
 		}
 	}
 	else if( numSamples % 2 ) // Odd numSamples
 	{
-		int _frameIdx = ( numSamples+1 ) / 2;
-		hair = convertCommon(curves[_frameIdx]);
+		int _frameIdx = numSamples / 2;
+		resampler.reset( new KeyResampler( curves[_frameIdx], density ) );
+		hair = convertCommon( curves[_frameIdx], *resampler );
 
 		for( int i = 0; i < numSamples; ++i )
 		{
 			if( i == _frameIdx )
 				continue;
-			samples.push_back( curves[i] );
+			samples.push_back( MotionSample( curves[i], nullptr ) );
 		}
 	}
 	else // Even numSamples
@@ -194,17 +615,18 @@ ccl::Object *convert( const vector<const IECoreScene::CurvesPrimitive *> &curves
 		int _frameIdx = numSamples / 2 - 1;
 		const V3fVectorData *p1 = curves[_frameIdx]->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
 		const V3fVectorData *p2 = curves[_frameIdx+1]->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
-		if( p1 && p2 )
+		resampler.reset( new KeyResampler( curves[_frameIdx], density ) );
+		hair = convertCommon( curves[_frameIdx], *resampler );
+		if( p1 && p2 && p1->readable().size() == p2->readable().size() )
 		{
-			midMesh = curves[_frameIdx]->copy();
-			V3fVectorData *midP = midMesh->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
-			IECore::LinearInterpolator<std::vector<V3f>>()( p1->readable(), p2->readable(), 0.5f, midP->writable() );
-			hair = convertCommon( midMesh.get() );
+			// Interpolate the reference sample in place.
+			writeKeys( *resampler, p1->readable(), &p2->readable(), hair->get_curve_keys().data() );
+			hair->tag_curve_keys_modified();
 		}
 
 		for( int i = 0; i < numSamples; ++i )
 		{
-			samples.push_back( curves[i] );
+			samples.push_back( MotionSample( curves[i], nullptr ) );
 		}
 	}
 
@@ -212,12 +634,13 @@ ccl::Object *convert( const vector<const IECoreScene::CurvesPrimitive *> &curves
 	hair->set_use_motion_blur( true );
 	hair->set_motion_steps( samples.size() + 1 );
 	ccl::Attribute *attr_mP = hair->attributes.add( ccl::ATTR_STD_MOTION_VERTEX_POSITION, ccl::ustring("motion_P") );
-	ccl::float3 *mP = attr_mP->data_float3();
+	ccl::float4 *mP = attr_mP->data_float4();
+	const float *radius = hair->get_curve_radius().data();
 
 	for( size_t i = 0; i < samples.size(); ++i )
 	{
-		PrimitiveVariableMap::const_iterator pIt = samples[i]->variables.find( "P" );
-		if( pIt != samples[i]->variables.end() )
+		PrimitiveVariableMap::const_iterator pIt = samples[i].first->variables.find( "P" );
+		if( pIt != samples[i].first->variables.end() )
 		{
 			const V3fVectorData *p = runTimeCast<const V3fVectorData>( pIt->second.data.get() );
 			if( p )
@@ -225,13 +648,19 @@ ccl::Object *convert( const vector<const IECoreScene::CurvesPrimitive *> &curves
 				PrimitiveVariable::Interpolation pInterpolation = pIt->second.interpolation;
 				if( pInterpolation == PrimitiveVariable::Varying || pInterpolation == PrimitiveVariable::Vertex || pInterpolation == PrimitiveVariable::FaceVarying )
 				{
-					// Vertex positions
-					const V3fVectorData *p = samples[i]->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
-					const std::vector<V3f> &points = p->readable();
-					size_t numVerts = p->readable().size();
+					if( p->readable().size() != resampler->numVertices() )
+					{
+						msg( Msg::Warning, "IECoreCycles::CurvesAlgo::convert", "Variable \"Position\" has inconsistent size between motion samples - not generating sampled Position." );
+						hair->attributes.remove( attr_mP );
+						hair->set_motion_steps( 0 );
+						hair->set_use_motion_blur( false );
+						break;
+					}
 
-					for( size_t j = 0; j < numVerts; ++j, ++mP )
-						*mP = ccl::make_float3( points[j].x, points[j].y, points[j].z );
+					// Vertex positions
+					const V3fVectorData *p2 = samples[i].second ? samples[i].second->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex ) : nullptr;
+					writeMotionKeys( *resampler, p->readable(), p2 ? &p2->readable() : nullptr, radius, mP );
+					mP += resampler->numKeys();
 				}
 				else
 				{
@@ -239,6 +668,7 @@ ccl::Object *convert( const vector<const IECoreScene::CurvesPrimitive *> &curves
 					hair->attributes.remove( attr_mP );
 					hair->set_motion_steps( 0 );
 					hair->set_use_motion_blur( false );
+					break;
 				}
 			}
 			else
@@ -247,10 +677,10 @@ ccl::Object *convert( const vector<const IECoreScene::CurvesPrimitive *> &curves
 				hair->attributes.remove( attr_mP );
 				hair->set_motion_steps( 0 );
 				hair->set_use_motion_blur( false );
+				break;
 			}
 		}
 	}
-	mP = attr_mP->data_float3();
 
 	ccl::Object *cobject = new ccl::Object();
 	cobject->set_geometry( hair );
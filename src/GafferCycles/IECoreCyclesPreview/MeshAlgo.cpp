@@ -37,18 +37,27 @@
 #include "GafferCycles/IECoreCyclesPreview/AttributeAlgo.h"
 #include "GafferCycles/IECoreCyclesPreview/ObjectAlgo.h"
 
-#include "IECoreScene/MeshNormalsOp.h"
+#include "PackingAlgo.h"
+
 #include "IECoreScene/MeshPrimitive.h"
-#include "IECoreScene/MeshAlgo.h"
 
-#include "IECore/Interpolator.h"
+#include "IECore/LRUCache.h"
 #include "IECore/SimpleTypedData.h"
 
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task_arena.h"
+
+#include <algorithm>
+#include <atomic>
+#include <unordered_map>
+
 // Cycles
 #include "kernel/types.h"
 #include "scene/geometry.h"
 #include "scene/mesh.h"
 #include "subd/dice.h"
+#include "util/math.h"
 #include "util/param.h"
 #include "util/types.h"
 
@@ -69,7 +78,7 @@ struct MikkUserData {
 				  ccl::Mesh *mesh,
 				  ccl::float3 *tangent,
 				  float *tangent_sign )
-		: mesh( mesh ), texface( NULL ), tangent( tangent ), tangent_sign( tangent_sign )
+		: mesh( mesh ), faces( nullptr ), num_faces( 0 ), corner_normal( nullptr ), vertex_normal( nullptr ), texface( NULL ), orco( nullptr ), tangent( tangent ), tangent_sign( tangent_sign )
 	{
 		const ccl::AttributeSet &attributes = (mesh->get_num_subd_faces()) ? mesh->subd_attributes :
 																		  mesh->attributes;
@@ -111,6 +120,8 @@ struct MikkUserData {
 	}
 
 	ccl::Mesh *mesh;
+	// When set, mikktspace sees only these `num_faces` faces of the mesh.
+	const int *faces;
 	int num_faces;
 
 	ccl::float3* corner_normal;
@@ -126,7 +137,11 @@ struct MikkUserData {
 static int mikk_get_num_faces( const SMikkTSpaceContext *context )
 {
 	const MikkUserData *userdata = (const MikkUserData *)context->m_pUserData;
-	if( userdata->mesh->get_num_subd_faces() )
+	if( userdata->faces )
+	{
+		return userdata->num_faces;
+	}
+	else if( userdata->mesh->get_num_subd_faces() )
 	{
 		return userdata->mesh->get_num_subd_faces();
 	}
@@ -136,13 +151,18 @@ static int mikk_get_num_faces( const SMikkTSpaceContext *context )
 	}
 }
 
+static int mikk_face( const MikkUserData *userdata, const int face_num )
+{
+	return userdata->faces ? userdata->faces[face_num] : face_num;
+}
+
 static int mikk_get_num_verts_of_face( const SMikkTSpaceContext *context, const int face_num )
 {
 	const MikkUserData *userdata = (const MikkUserData *)context->m_pUserData;
 	if( userdata->mesh->get_num_subd_faces() )
 	{
 		const ccl::Mesh *mesh = userdata->mesh;
-		return mesh->get_subd_num_corners()[face_num];
+		return mesh->get_subd_num_corners()[mikk_face( userdata, face_num )];
 	}
 	else
 	{
@@ -178,10 +198,11 @@ static int mikk_corner_index( const ccl::Mesh *mesh, const int face_num, const i
 
 static void mikk_get_position( const SMikkTSpaceContext *context,
 							   float P[3],
-							   const int face_num,
+							   const int mikk_face_num,
 							   const int vert_num )
 {
 	const MikkUserData *userdata = (const MikkUserData *)context->m_pUserData;
+	const int face_num = mikk_face( userdata, mikk_face_num );
 	const ccl::Mesh *mesh = userdata->mesh;
 	const int vertex_index = mikk_vertex_index(mesh, face_num, vert_num);
 	const ccl::float3 vP = mesh->get_verts()[vertex_index];
@@ -192,10 +213,11 @@ static void mikk_get_position( const SMikkTSpaceContext *context,
 
 static void mikk_get_texture_coordinate( const SMikkTSpaceContext *context,
 										 float uv[2],
-										 const int face_num,
+										 const int mikk_face_num,
 										 const int vert_num )
 {
 	const MikkUserData *userdata = (const MikkUserData *)context->m_pUserData;
+	const int face_num = mikk_face( userdata, mikk_face_num );
 	const ccl::Mesh *mesh = userdata->mesh;
 	if( userdata->texface != NULL )
 	{
@@ -224,10 +246,11 @@ static void mikk_get_texture_coordinate( const SMikkTSpaceContext *context,
 
 static void mikk_get_normal( const SMikkTSpaceContext *context,
 							 float N[3],
-							 const int face_num,
+							 const int mikk_face_num,
 							 const int vert_num)
 {
 	const MikkUserData *userdata = (const MikkUserData *)context->m_pUserData;
+	const int face_num = mikk_face( userdata, mikk_face_num );
 	const ccl::Mesh *mesh = userdata->mesh;
 	ccl::float3 vN;
 	if( mesh->get_num_subd_faces() )
@@ -253,7 +276,7 @@ static void mikk_get_normal( const SMikkTSpaceContext *context,
 		{
 			vN = userdata->corner_normal[face_num * 3 + vert_num];
 		}
-		if( mesh->get_smooth()[face_num] )
+		else if( mesh->get_smooth()[face_num] )
 		{
 			const int vertex_index = mikk_vertex_index( mesh, face_num, vert_num );
 			vN = userdata->vertex_normal[vertex_index];
@@ -272,10 +295,11 @@ static void mikk_get_normal( const SMikkTSpaceContext *context,
 static void mikk_set_tangent_space(const SMikkTSpaceContext *context,
 								   const float T[],
 								   const float sign,
-								   const int face_num,
+								   const int mikk_face_num,
 								   const int vert_num)
 {
 	MikkUserData *userdata = (MikkUserData *)context->m_pUserData;
+	const int face_num = mikk_face( userdata, mikk_face_num );
 	const ccl::Mesh *mesh = userdata->mesh;
 	const int corner_index = mikk_corner_index( mesh, face_num, vert_num );
 	userdata->tangent[corner_index] = ccl::make_float3( T[0], T[1], T[2] );
@@ -285,6 +309,125 @@ static void mikk_set_tangent_space(const SMikkTSpaceContext *context,
 	}
 }
 
+static void mikk_gen_tangents( const MikkUserData &userdata )
+{
+	/* Setup interface. */
+	SMikkTSpaceInterface sm_interface;
+	memset( &sm_interface, 0, sizeof( sm_interface ) );
+	sm_interface.m_getNumFaces = mikk_get_num_faces;
+	sm_interface.m_getNumVerticesOfFace = mikk_get_num_verts_of_face;
+	sm_interface.m_getPosition = mikk_get_position;
+	sm_interface.m_getTexCoord = mikk_get_texture_coordinate;
+	sm_interface.m_getNormal = mikk_get_normal;
+	sm_interface.m_setTSpaceBasic = mikk_set_tangent_space;
+	/* Setup context. */
+	SMikkTSpaceContext context;
+	memset( &context, 0, sizeof( context ) );
+	context.m_pUserData = const_cast<MikkUserData *>( &userdata );
+	context.m_pInterface = &sm_interface;
+	/* Compute tangents. */
+	genTangSpaceDefault( &context );
+}
+
+// Mikktspace only shares tangent space between faces that meet at a
+// vertex with the same position (and normal and UV), so faces that aren't
+// connected by such a vertex can be processed independently. We group the
+// faces into connected components, and pack those into chunks of roughly
+// equal size. Each chunk lists its faces in their original order, which is
+// all that mikktspace is sensitive to, so processing the chunks separately
+// gives results identical to processing the whole mesh at once.
+struct MikkPositionHash
+{
+	size_t operator()( const V3f &p ) const
+	{
+		// Mikktspace compares positions with `==`, for which -0 and 0
+		// are equal, so they must hash equally too.
+		IECore::MurmurHash h;
+		h.append( V3f( p.x == 0.0f ? 0.0f : p.x, p.y == 0.0f ? 0.0f : p.y, p.z == 0.0f ? 0.0f : p.z ) );
+		return h.h1();
+	}
+};
+
+static std::vector<std::vector<int>> mikk_chunks( ccl::Mesh *mesh )
+{
+	std::vector<std::vector<int>> chunks;
+
+	const bool subd = mesh->get_num_subd_faces();
+	const int numFaces = subd ? mesh->get_num_subd_faces() : mesh->num_triangles();
+	const size_t minChunkSize = 10000;
+	if( numFaces < 2 * (int)minChunkSize )
+	{
+		return chunks;
+	}
+
+	// Start with each vertex connected to the first vertex with the
+	// same position, so that vertices mikktspace might weld are always
+	// in the same component.
+	const ccl::array<ccl::float3> &verts = mesh->get_verts();
+	std::vector<int> parent( verts.size() );
+	{
+		std::unordered_map<V3f, int, MikkPositionHash> firstVertex;
+		firstVertex.reserve( verts.size() );
+		for( size_t v = 0; v < verts.size(); ++v )
+		{
+			parent[v] = firstVertex.insert( { V3f( verts[v].x, verts[v].y, verts[v].z ), (int)v } ).first->second;
+		}
+	}
+
+	auto root = [&parent]( int v ) {
+		while( parent[v] != v )
+		{
+			parent[v] = parent[parent[v]];
+			v = parent[v];
+		}
+		return v;
+	};
+
+	for( int face = 0; face < numFaces; ++face )
+	{
+		int r0 = root( mikk_vertex_index( mesh, face, 0 ) );
+		const int numCorners = subd ? mesh->get_subd_num_corners()[face] : 3;
+		for( int corner = 1; corner < numCorners; ++corner )
+		{
+			const int r = root( mikk_vertex_index( mesh, face, corner ) );
+			if( r != r0 )
+			{
+				parent[std::max( r, r0 )] = std::min( r, r0 );
+				r0 = std::min( r, r0 );
+			}
+		}
+	}
+
+	std::vector<int> faceComponents( numFaces );
+	std::vector<int> componentSizes( verts.size(), 0 );
+	for( int face = 0; face < numFaces; ++face )
+	{
+		faceComponents[face] = root( mikk_vertex_index( mesh, face, 0 ) );
+		componentSizes[faceComponents[face]]++;
+	}
+
+	const size_t chunkSize = std::max( minChunkSize, (size_t)numFaces / ( 4 * tbb::this_task_arena::max_concurrency() ) );
+	std::vector<int> componentChunks( verts.size(), -1 );
+	size_t currentChunkSize = chunkSize;
+	for( int face = 0; face < numFaces; ++face )
+	{
+		int &chunk = componentChunks[faceComponents[face]];
+		if( chunk == -1 )
+		{
+			if( currentChunkSize >= chunkSize )
+			{
+				chunks.push_back( std::vector<int>() );
+				currentChunkSize = 0;
+			}
+			chunk = chunks.size() - 1;
+			currentChunkSize += componentSizes[faceComponents[face]];
+		}
+		chunks[chunk].push_back( face );
+	}
+
+	return chunks;
+}
+
 static void mikk_compute_tangents( const char *layer_name, ccl::Mesh *mesh, bool need_sign, bool active_render )
 {
 	/* Create tangent attributes. */
@@ -337,23 +480,27 @@ static void mikk_compute_tangents( const char *layer_name, ccl::Mesh *mesh, bool
 		tangent_sign = attr_sign->data_float();
 	}
 	/* Setup userdata. */
-	MikkUserData userdata( layer_name, mesh, tangent, tangent_sign );
-	/* Setup interface. */
-	SMikkTSpaceInterface sm_interface;
-	memset( &sm_interface, 0, sizeof( sm_interface ) );
-	sm_interface.m_getNumFaces = mikk_get_num_faces;
-	sm_interface.m_getNumVerticesOfFace = mikk_get_num_verts_of_face;
-	sm_interface.m_getPosition = mikk_get_position;
-	sm_interface.m_getTexCoord = mikk_get_texture_coordinate;
-	sm_interface.m_getNormal = mikk_get_normal;
-	sm_interface.m_setTSpaceBasic = mikk_set_tangent_space;
-	/* Setup context. */
-	SMikkTSpaceContext context;
-	memset( &context, 0, sizeof( context ) );
-	context.m_pUserData = &userdata;
-	context.m_pInterface = &sm_interface;
-	/* Compute tangents. */
-	genTangSpaceDefault( &context );
+	const MikkUserData userdata( layer_name, mesh, tangent, tangent_sign );
+	/* Compute tangents, for independent chunks in parallel. */
+	const std::vector<std::vector<int>> chunks = mikk_chunks( mesh );
+	if( chunks.size() < 2 )
+	{
+		mikk_gen_tangents( userdata );
+		return;
+	}
+
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, chunks.size(), 1 ),
+		[&]( const tbb::blocked_range<size_t> &r ) {
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				MikkUserData chunkUserdata = userdata;
+				chunkUserdata.faces = chunks[i].data();
+				chunkUserdata.num_faces = chunks[i].size();
+				mikk_gen_tangents( chunkUserdata );
+			}
+		}
+	);
 }
 
 } // namespace
@@ -396,6 +543,42 @@ const V3fVectorData *normal( const IECoreScene::MeshPrimitive *mesh, PrimitiveVa
 	return n;
 }
 
+// As above, but also checking that the size and indices of "N" match the
+// mesh, so that the result can be converted without further checks.
+const PrimitiveVariable *validNormal( const IECoreScene::MeshPrimitive *mesh, PrimitiveVariable::Interpolation &interpolation )
+{
+	const V3fVectorData *data = normal( mesh, interpolation );
+	if( !data )
+	{
+		return nullptr;
+	}
+
+	const PrimitiveVariable &n = mesh->variables.find( "N" )->second;
+	const vector<V3f> &normals = data->readable();
+	const size_t expectedSize = mesh->variableSize( interpolation );
+	const size_t size = n.indices ? n.indices->readable().size() : normals.size();
+	if( size != expectedSize )
+	{
+		msg(
+			Msg::Warning, "IECoreCycles::MeshAlgo",
+			boost::format( "Variable \"N\" has an invalid %s size \"%d\" (expected \"%d\") - not converting normals." ) % ( n.indices ? "index" : "data" ) % size % expectedSize
+		);
+		return nullptr;
+	}
+
+	if( n.indices )
+	{
+		const std::vector<int> &indices = n.indices->readable();
+		if( std::any_of( indices.begin(), indices.end(), [&normals]( int i ) { return i < 0 || (size_t)i >= normals.size(); } ) )
+		{
+			msg( Msg::Warning, "IECoreCycles::MeshAlgo", "Variable \"N\" has out of range indices - not converting normals." );
+			return nullptr;
+		}
+	}
+
+	return &n;
+}
+
 const BoolVectorData *getSmooth( const IECoreScene::MeshPrimitive *mesh )
 {
 	PrimitiveVariableMap::const_iterator it = mesh->variables.find( "_smooth" );
@@ -446,109 +629,215 @@ ccl::AttributeStandard normalAttributeStandard( PrimitiveVariable::Interpolation
 #endif
 }
 
-void convertN( const IECoreScene::MeshPrimitive *mesh, const V3fVectorData *normalData, ccl::Attribute *attr, PrimitiveVariable::Interpolation interpolation )
+// Describes a fan triangulation of a mesh, without building a triangulated
+// copy of it. Triangle corners and faces refer back to the corners and
+// faces of the original mesh, so that face-varying and uniform primitive
+// variables can be remapped through them as they are written to Cycles.
+struct Triangulation
 {
-	const size_t numFaces = mesh->numFaces();
-	const std::vector<int> &vertsPerFace = mesh->verticesPerFace()->readable();
-	const vector<Imath::V3f> &normals = normalData->readable();
-	const IECore::IntVectorData* nIndices = mesh->variables.find( "N" )->second.indices.get();
-	ccl::float3 *cdata = attr->data_float3();
-	size_t vertex = 0;
+	// The vertex for each triangle corner.
+	std::vector<int> vertexIds;
+	// The original corner for each triangle corner.
+	std::vector<int> corners;
+	// The original face for each triangle.
+	std::vector<int> faces;
+};
 
-	if( !nIndices )
+void triangulate( const IECoreScene::MeshPrimitive *mesh, Triangulation &triangulation )
+{
+	const vector<int> &vertsPerFace = mesh->verticesPerFace()->readable();
+	const vector<int> &vertexIds = mesh->vertexIds()->readable();
+	const size_t numFaces = vertsPerFace.size();
+
+	std::vector<size_t> cornerOffsets( numFaces + 1, 0 );
+	std::vector<size_t> triangleOffsets( numFaces + 1, 0 );
+	for( size_t i = 0; i < numFaces; ++i )
 	{
-		if( interpolation == PrimitiveVariable::Constant )
-		{
-			for( size_t i = 0; i < normals.size(); ++i )
-			{
-				*(cdata++) = ccl::make_float3( normals[0].x, normals[0].y, normals[0].z );
-			}
-		}
-		else if( interpolation == PrimitiveVariable::Uniform )
-		{
-			for( size_t i = 0; i < numFaces; ++i )
-			{
-				for( size_t j = 0; j < vertsPerFace[i]; ++j )
-				{
-					*(cdata++) = ccl::make_float3( normals[i].x, normals[i].y, normals[i].z );
-				}
-			}
-		}
-#ifdef WITH_CYCLES_CORNER_NORMALS
-		else if( interpolation == PrimitiveVariable::FaceVarying )
-		{
-			for( size_t i = 0; i < numFaces; ++i )
+		cornerOffsets[i + 1] = cornerOffsets[i] + vertsPerFace[i];
+		triangleOffsets[i + 1] = triangleOffsets[i] + std::max( vertsPerFace[i] - 2, 0 );
+	}
+
+	const size_t numTriangles = triangleOffsets.back();
+	triangulation.vertexIds.resize( numTriangles * 3 );
+	triangulation.corners.resize( numTriangles * 3 );
+	triangulation.faces.resize( numTriangles );
+
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numFaces ),
+		[&]( const tbb::blocked_range<size_t> &r ) {
+			for( size_t i = r.begin(); i != r.end(); ++i )
 			{
-				for( size_t j = 0; j < vertsPerFace[i]; ++j, ++vertex )
+				const int firstCorner = cornerOffsets[i];
+				for( size_t t = triangleOffsets[i], k = 1; t < triangleOffsets[i + 1]; ++t, ++k )
 				{
-					*(cdata++) = ccl::make_float3( normals[vertex].x, normals[vertex].y, normals[vertex].z );
+					const int c[3] = { firstCorner, (int)( firstCorner + k ), (int)( firstCorner + k + 1 ) };
+					for( int j = 0; j < 3; ++j )
+					{
+						triangulation.corners[t * 3 + j] = c[j];
+						triangulation.vertexIds[t * 3 + j] = vertexIds[c[j]];
+					}
+					triangulation.faces[t] = i;
 				}
 			}
 		}
-#endif // WITH_CYCLES_CORNER_NORMALS
-		else // per-vertex
-		{
-			for( size_t i = 0; i < normals.size(); ++i )
+	);
+}
+
+// Returns a copy of `primitiveVariable` that refers to the triangles rather
+// than the original faces. Only the indices are rebuilt - the data is shared.
+PrimitiveVariable triangulatedVariable( const PrimitiveVariable &primitiveVariable, const Triangulation &triangulation )
+{
+	const std::vector<int> *remap = nullptr;
+	if( primitiveVariable.interpolation == PrimitiveVariable::FaceVarying )
+	{
+		remap = &triangulation.corners;
+	}
+	else if( primitiveVariable.interpolation == PrimitiveVariable::Uniform )
+	{
+		remap = &triangulation.faces;
+	}
+	else
+	{
+		return primitiveVariable;
+	}
+
+	IntVectorDataPtr indicesData = new IntVectorData;
+	std::vector<int> &indices = indicesData->writable();
+	indices.resize( remap->size() );
+	const int *originalIndices = primitiveVariable.indices ? primitiveVariable.indices->readable().data() : nullptr;
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, remap->size() ),
+		[&]( const tbb::blocked_range<size_t> &r ) {
+			for( size_t i = r.begin(); i != r.end(); ++i )
 			{
-				*(cdata++) = ccl::make_float3( normals[i].x, normals[i].y, normals[i].z );
+				const int j = (*remap)[i];
+				indices[i] = originalIndices ? originalIndices[j] : j;
 			}
 		}
+	);
+
+	return PrimitiveVariable( primitiveVariable.interpolation, primitiveVariable.data, indicesData );
+}
+
+// Writes the normals into `cdata`, which has room for `size` elements.
+// Expects `n` to have been checked by `validNormal()`, and returns false
+// without writing anything if the normals don't fill `cdata` exactly, as
+// happens when uniform normals are converted without corner normals.
+bool convertN( const IECoreScene::MeshPrimitive *mesh, const PrimitiveVariable &n, ccl::float3 *cdata, size_t size, const Triangulation *triangulation = nullptr )
+{
+	const size_t numFaces = mesh->numFaces();
+	const std::vector<int> &vertsPerFace = mesh->verticesPerFace()->readable();
+	const vector<Imath::V3f> &normals = static_cast<const V3fVectorData *>( n.data.get() )->readable();
+	const IECore::IntVectorData* nIndices = n.indices.get();
+	const PrimitiveVariable::Interpolation interpolation = n.interpolation;
+	const size_t numCorners = mesh->variableSize( PrimitiveVariable::FaceVarying );
+
+	// The number of elements written by each of the loops below.
+	size_t numElements = size;
+	switch( interpolation )
+	{
+		case PrimitiveVariable::Constant :
+			break;
+		case PrimitiveVariable::Uniform :
+			numElements = triangulation ? triangulation->corners.size() : numCorners;
+			break;
+#ifdef WITH_CYCLES_CORNER_NORMALS
+		case PrimitiveVariable::FaceVarying :
+			numElements = triangulation ? triangulation->corners.size() : numCorners;
+			break;
+#endif
+		default :
+			numElements = mesh->variableSize( interpolation );
+			break;
 	}
-	else
+
+	if( numElements != size )
 	{
-		const vector<int> indices = nIndices->readable();
+		msg(
+			Msg::Warning, "IECoreCycles::MeshAlgo::convertN",
+			boost::format( "Variable \"N\" would convert to %d normals rather than the %d expected - not converting normals." ) % numElements % size
+		);
+		return false;
+	}
 
-		size_t numVerts = 0;
-		for( auto vert : vertsPerFace )
-		{
-			numVerts += vert;
-		}
+	// Indices are resolved up front, so each of the loops below is a
+	// straight gather which we can split across threads.
+	const int *indices = nIndices ? nIndices->readable().data() : nullptr;
+	auto normal = [&normals, indices]( size_t i ) {
+		const Imath::V3f &n = normals[indices ? indices[i] : i];
+		return ccl::make_float3( n.x, n.y, n.z );
+	};
 
-		if( ( indices.size() < numVerts ) && interpolation != PrimitiveVariable::Vertex )
+	if( interpolation == PrimitiveVariable::Constant )
+	{
+		std::fill( cdata, cdata + size, normal( 0 ) );
+	}
+	else if( interpolation == PrimitiveVariable::Uniform && triangulation )
+	{
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, triangulation->corners.size() ),
+			[&]( const tbb::blocked_range<size_t> &r ) {
+				for( size_t i = r.begin(); i != r.end(); ++i )
+				{
+					cdata[i] = normal( triangulation->faces[i / 3] );
+				}
+			}
+		);
+	}
+	else if( interpolation == PrimitiveVariable::Uniform )
+	{
+		std::vector<size_t> faceOffsets( numFaces + 1, 0 );
+		for( size_t i = 0; i < numFaces; ++i )
 		{
-			msg(
-				Msg::Warning, "IECoreCycles::MeshAlgo::convertN",
-				boost::format( "Normal has an invalid index size \"%d\" to vertex size \"%d\"." ) % indices.size() % numVerts
-			);
-			return;
+			faceOffsets[i + 1] = faceOffsets[i] + vertsPerFace[i];
 		}
 
-		if( interpolation == PrimitiveVariable::Uniform )
-		{
-			for( size_t i = 0; i < numFaces; ++i )
-			{
-				for( size_t j = 0; j < vertsPerFace[i]; ++j )
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, numFaces ),
+			[&]( const tbb::blocked_range<size_t> &r ) {
+				for( size_t i = r.begin(); i != r.end(); ++i )
 				{
-					*(cdata++) = ccl::make_float3( normals[indices[i]].x, normals[indices[i]].y, normals[indices[i]].z );
+					const ccl::float3 n = normal( i );
+					for( size_t j = faceOffsets[i]; j < faceOffsets[i + 1]; ++j )
+					{
+						cdata[j] = n;
+					}
 				}
 			}
-		}
+		);
+	}
 #ifdef WITH_CYCLES_CORNER_NORMALS
-		else if( interpolation == PrimitiveVariable::FaceVarying )
-		{
-			for( size_t i = 0; i < numFaces; ++i )
-			{
-				for( size_t j = 0; j < vertsPerFace[i]; ++j, ++vertex )
+	else if( interpolation == PrimitiveVariable::FaceVarying )
+	{
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, triangulation ? triangulation->corners.size() : numCorners ),
+			[&]( const tbb::blocked_range<size_t> &r ) {
+				for( size_t i = r.begin(); i != r.end(); ++i )
 				{
-					*(cdata++) = ccl::make_float3( normals[indices[vertex]].x, normals[indices[vertex]].y, normals[indices[vertex]].z );
+					cdata[i] = normal( triangulation ? triangulation->corners[i] : i );
 				}
 			}
-		}
+		);
+	}
 #endif // WITH_CYCLES_CORNER_NORMALS
-		else // per-vertex
-		{
-			for( size_t i = 0; i < normals.size(); ++i )
-			{
-				*(cdata++) = ccl::make_float3( normals[indices[i]].x, normals[indices[i]].y, normals[indices[i]].z );
+	else // per-vertex
+	{
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, numElements ),
+			[&]( const tbb::blocked_range<size_t> &r ) {
+				for( size_t i = r.begin(); i != r.end(); ++i )
+				{
+					cdata[i] = normal( i );
+				}
 			}
-		}
+		);
 	}
-	
+
+	return true;
 }
 
-void convertUVSet( const string &uvSet, const IECoreScene::PrimitiveVariable &uvVariable, const IECoreScene::MeshPrimitive *mesh, ccl::AttributeSet &attributes, bool subdivision_uvs, bool defaultUV )//, ccl::Mesh *cmesh )
+void convertUVSet( const string &uvSet, const IECoreScene::PrimitiveVariable &uvVariable, const IECoreScene::MeshPrimitive *mesh, const Triangulation *triangulation, ccl::AttributeSet &attributes, bool subdivision_uvs, bool defaultUV )
 {
-	size_t numFaces = mesh->numFaces();
 	const V2fVectorData *uvData = runTimeCast<V2fVectorData>( uvVariable.data.get() );
 
 	if( !uvData )
@@ -567,6 +856,16 @@ void convertUVSet( const string &uvSet, const IECoreScene::PrimitiveVariable &uv
 
 	const vector<Imath::V2f> &uvs = uvData->readable();
 	const std::vector<int> &vertexIds = mesh->vertexIds()->readable();
+	const size_t numCorners = vertexIds.size();
+
+	if( uvVariable.indices && ( uvVariable.indices->readable().size() < numCorners ) && uvVariable.interpolation != PrimitiveVariable::Vertex )
+	{
+		msg(
+			Msg::Warning, "IECoreCycles::MeshAlgo::convertUVSet",
+			boost::format( "Variable \"%s\" has an invalid index size \"%d\" to vertex size \"%d\"." ) % uvSet % uvVariable.indices->readable().size() % numCorners
+		);
+		return;
+	}
 
 	ccl::Attribute *uv_attr = nullptr;
 	if( defaultUV )
@@ -578,106 +877,370 @@ void convertUVSet( const string &uvSet, const IECoreScene::PrimitiveVariable &uv
 	if( subdivision_uvs )
 		uv_attr->flags |= ccl::ATTR_SUBDIVIDED;
 
-	// We need to know how many verts there are
-	const vector<int> &vertsPerFace = mesh->verticesPerFace()->readable();
+	// Corners are stored in face order in both Cortex and Cycles, so we
+	// can fill them with a flat loop over the corners, remapping through
+	// the triangulation if there is one.
+	const int *indices = uvVariable.indices ? uvVariable.indices->readable().data() : nullptr;
+	const int *cornerVertexIds = triangulation ? triangulation->vertexIds.data() : vertexIds.data();
+	const int *corners = triangulation ? triangulation->corners.data() : nullptr;
+	const bool vertexInterpolation = uvVariable.interpolation == PrimitiveVariable::Vertex;
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, triangulation ? triangulation->corners.size() : numCorners ),
+		[&]( const tbb::blocked_range<size_t> &r ) {
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				const size_t j = vertexInterpolation ? cornerVertexIds[i] : ( corners ? corners[i] : i );
+				const Imath::V2f &uv = uvs[indices ? indices[j] : j];
+				fdata[i] = ccl::make_float2( uv.x, uv.y );
+			}
+		}
+	);
+}
 
-	size_t vertex = 0;
-	if( uvVariable.indices )
-	{
-		const vector<int> &indices = uvVariable.indices->readable();
+void convertVertices( const vector<Imath::V3f> &points, ccl::Mesh *cmesh )
+{
+	PackingAlgo::pack( points.data(), cmesh->get_verts().data(), points.size() );
+	cmesh->tag_verts_modified();
+}
 
-		size_t numVerts = 0;
-		for( auto vert : vertsPerFace )
+bool defaultSmooth( const IECoreScene::MeshPrimitive *mesh )
+{
+	PrimitiveVariableMap::const_iterator sIt = mesh->variables.find( "_smooth" );
+	if( sIt != mesh->variables.end() && sIt->second.interpolation == PrimitiveVariable::Constant )
+	{
+		if( const BoolData *data = runTimeCast<const BoolData>( sIt->second.data.get() ) )
 		{
-			numVerts += vert;
+			return data->readable();
 		}
+	}
+	return true;
+}
+
+// Returns true if every face of the mesh is smooth shaded.
+bool allSmooth( const IECoreScene::MeshPrimitive *mesh )
+{
+	if( const BoolVectorData *s = getSmooth( mesh ) )
+	{
+		const vector<bool> &smooth = s->readable();
+		return std::find( smooth.begin(), smooth.end(), false ) == smooth.end();
+	}
+	return defaultSmooth( mesh );
+}
 
-		if( ( indices.size() < numVerts ) && uvVariable.interpolation != PrimitiveVariable::Vertex )
+//////////////////////////////////////////////////////////////////////////
+// Topology cache
+//////////////////////////////////////////////////////////////////////////
+
+// The parts of a polygon mesh conversion that depend only on its topology.
+// Deforming meshes typically have the same topology on every frame, so we
+// cache these and only convert positions and normals on subsequent frames.
+struct Topology : public IECore::RefCounted
+{
+
+	// Null if the mesh is already made of triangles.
+	std::unique_ptr<Triangulation> triangulation;
+	ccl::array<int> triangles;
+	ccl::array<int> shader;
+	ccl::array<bool> smooth;
+	// The triangle corners using each vertex, stored as `vertexCorners[vertexCornerOffsets[v]]`
+	// to `vertexCorners[vertexCornerOffsets[v+1]]`. Used to gather vertex normals without
+	// needing to synchronise writes.
+	std::vector<int> vertexCornerOffsets;
+	std::vector<int> vertexCorners;
+
+	size_t memoryUsage() const
+	{
+		size_t result = sizeof( Topology ) + triangles.size() * sizeof( int ) + shader.size() * sizeof( int ) + smooth.size() * sizeof( bool );
+		result += ( vertexCornerOffsets.size() + vertexCorners.size() ) * sizeof( int );
+		if( triangulation )
 		{
-			msg(
-				Msg::Warning, "IECoreCycles::MeshAlgo::convertUVSet",
-				boost::format( "Variable \"%s\" has an invalid index size \"%d\" to vertex size \"%d\"." ) % uvSet % indices.size() % numVerts
-			);
-			attributes.remove( uv_attr );
-			return;
+			result += ( triangulation->vertexIds.size() + triangulation->corners.size() + triangulation->faces.size() ) * sizeof( int );
 		}
+		return result;
+	}
 
-		if( uvVariable.interpolation == PrimitiveVariable::Vertex )
+};
+
+IE_CORE_DECLAREPTR( Topology )
+
+IECore::MurmurHash topologyHash( const IECoreScene::MeshPrimitive *mesh )
+{
+	IECore::MurmurHash h;
+	h.append( (uint64_t)mesh->variableSize( PrimitiveVariable::Vertex ) );
+	mesh->verticesPerFace()->hash( h );
+	mesh->vertexIds()->hash( h );
+	// Shader assignments and smoothing are baked into the cached arrays too.
+	for( const char *name : { "_smooth", "_facesetIndex" } )
+	{
+		PrimitiveVariableMap::const_iterator it = mesh->variables.find( name );
+		if( it != mesh->variables.end() )
 		{
-			for( size_t i = 0; i < numFaces; ++i )
+			h.append( name );
+			h.append( it->second.interpolation );
+			it->second.data->hash( h );
+		}
+	}
+	return h;
+}
+
+// Returns true if every vertex id refers to a point. The topology and the
+// conversions built from it index straight into per-vertex buffers, so
+// meshes failing this must be rejected before getting that far.
+bool validVertexIds( const IECoreScene::MeshPrimitive *mesh )
+{
+	const V3fVectorData *p = mesh->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
+	if( !p )
+	{
+		msg( Msg::Warning, "IECoreCycles::MeshAlgo::convert", "Mesh has no vertex \"P\" - not converting." );
+		return false;
+	}
+
+	const size_t numPoints = p->readable().size();
+	const vector<int> &vertexIds = mesh->vertexIds()->readable();
+	if( std::any_of( vertexIds.begin(), vertexIds.end(), [numPoints]( int i ) { return i < 0 || (size_t)i >= numPoints; } ) )
+	{
+		msg( Msg::Warning, "IECoreCycles::MeshAlgo::convert", boost::format( "Mesh has vertex ids outside the range of its %d points - not converting." ) % numPoints );
+		return false;
+	}
+
+	return true;
+}
+
+struct TopologyCacheGetterKey
+{
+
+	TopologyCacheGetterKey( const IECoreScene::MeshPrimitive *mesh )
+		:	mesh( mesh ), hash( topologyHash( mesh ) )
+	{
+	}
+
+	operator const IECore::MurmurHash & () const
+	{
+		return hash;
+	}
+
+	const IECoreScene::MeshPrimitive *mesh;
+	const IECore::MurmurHash hash;
+
+};
+
+ConstTopologyPtr topologyGetter( const TopologyCacheGetterKey &key, size_t &cost )
+{
+	const IECoreScene::MeshPrimitive *mesh = key.mesh;
+	TopologyPtr topology = new Topology;
+
+	if( mesh->maxVerticesPerFace() != 3 )
+	{
+		// Triangulate on the fly, rather than making a triangulated copy
+		// of the whole primitive.
+		topology->triangulation.reset( new Triangulation );
+		triangulate( mesh, *topology->triangulation );
+	}
+
+	const Triangulation *triangulation = topology->triangulation.get();
+	const vector<int> &vertexIds = triangulation ? triangulation->vertexIds : mesh->vertexIds()->readable();
+	const size_t numTriangles = vertexIds.size() / 3;
+	const int *faces = triangulation ? triangulation->faces.data() : nullptr;
+	const BoolVectorData *s = getSmooth( mesh );
+	const IntVectorData *f = getFaceset( mesh );
+	const bool smooth = defaultSmooth( mesh );
+
+	topology->triangles.resize( numTriangles * 3 );
+	topology->shader.resize( numTriangles );
+	topology->smooth.resize( numTriangles );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numTriangles ),
+		[&]( const tbb::blocked_range<size_t> &r ) {
+			for( size_t i = r.begin(); i != r.end(); ++i )
 			{
-				for( size_t j = 0; j < vertsPerFace[i]; ++j, ++vertex )
-				{
-					*(fdata++) = ccl::make_float2(uvs[indices[vertexIds[vertex]]].x, uvs[indices[vertexIds[vertex]]].y);
-				}
+				topology->triangles[i * 3] = vertexIds[i * 3];
+				topology->triangles[i * 3 + 1] = vertexIds[i * 3 + 1];
+				topology->triangles[i * 3 + 2] = vertexIds[i * 3 + 2];
+				const size_t face = faces ? faces[i] : i;
+				topology->shader[i] = f ? f->readable()[face] : 0;
+				topology->smooth[i] = s ? s->readable()[face] : smooth;
 			}
 		}
-		else // FaceVarying/Varying
-		{
-			for( size_t i = 0; i < numFaces; ++i )
+	);
+
+	// Vertex ids have been checked by `validVertexIds()`.
+	const size_t numVerts = mesh->variableSize( PrimitiveVariable::Vertex );
+	topology->vertexCornerOffsets.resize( numVerts + 1, 0 );
+	for( size_t i = 0; i < vertexIds.size(); ++i )
+	{
+		assert( vertexIds[i] >= 0 && (size_t)vertexIds[i] < numVerts );
+		topology->vertexCornerOffsets[vertexIds[i] + 1]++;
+	}
+	for( size_t v = 0; v < numVerts; ++v )
+	{
+		topology->vertexCornerOffsets[v + 1] += topology->vertexCornerOffsets[v];
+	}
+	topology->vertexCorners.resize( vertexIds.size() );
+	std::vector<int> cursors( topology->vertexCornerOffsets.begin(), topology->vertexCornerOffsets.end() - 1 );
+	for( size_t i = 0; i < vertexIds.size(); ++i )
+	{
+		topology->vertexCorners[cursors[vertexIds[i]]++] = i;
+	}
+
+	cost = topology->memoryUsage();
+	return topology;
+}
+
+typedef IECore::LRUCache<IECore::MurmurHash, ConstTopologyPtr, IECore::LRUCachePolicy::Parallel, TopologyCacheGetterKey> TopologyCache;
+// Cost is measured in bytes.
+TopologyCache g_topologyCache( topologyGetter, 512 * 1024 * 1024 );
+
+// Computes angle weighted vertex normals in the same way as
+// `IECoreScene::MeshAlgo::calculateNormals()`, but writing them straight
+// into a Cycles buffer instead of into a copy of the mesh.
+void computeNormals( const vector<V3f> &points, const Topology *topology, ccl::float3 *normals )
+{
+	const int *triangles = topology->triangles.data();
+	const std::vector<int> &offsets = topology->vertexCornerOffsets;
+	const std::vector<int> &corners = topology->vertexCorners;
+
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, std::min( points.size(), offsets.size() - 1 ) ),
+		[&]( const tbb::blocked_range<size_t> &r ) {
+			for( size_t v = r.begin(); v != r.end(); ++v )
 			{
-				for( size_t j = 0; j < vertsPerFace[i]; ++j, ++vertex )
+				V3f n( 0.0f );
+				for( int j = offsets[v]; j < offsets[v + 1]; ++j )
 				{
-					*(fdata++) = ccl::make_float2(uvs[indices[vertex]].x, uvs[indices[vertex]].y);
+					const int corner = corners[j];
+					const int first = corner - corner % 3;
+					const V3f &p0 = points[triangles[corner]];
+					const V3f &p1 = points[triangles[first + ( corner + 1 ) % 3]];
+					const V3f &p2 = points[triangles[first + ( corner + 2 ) % 3]];
+					const V3f e1 = p1 - p0;
+					const V3f e2 = p2 - p0;
+					const V3f faceNormal = e1.cross( e2 );
+					const float length = faceNormal.length();
+					if( length > 0.0f )
+					{
+						n += faceNormal * ( atan2f( length, e1.dot( e2 ) ) / length );
+					}
 				}
+				n.normalize();
+				normals[v] = ccl::make_float3( n.x, n.y, n.z );
 			}
 		}
-	}
-	else
-	{
-		if( uvVariable.interpolation == PrimitiveVariable::Vertex )
-		{
-			for( size_t i = 0; i < numFaces; ++i )
+	);
+}
+
+// Face-varying normals whose corners all agree at each vertex (within this
+// tolerance) are converted as vertex normals instead.
+const float g_vertexNormalTolerance = 1e-4f;
+
+// Returns true if the face-varying normals `n` are really per-vertex, in
+// which case `collapseNormals()` may be used to convert them. Both expect
+// `n` to have been checked by `validNormal()`.
+bool normalsAreVertex( const PrimitiveVariable &n, const Topology *topology )
+{
+#ifdef WITH_CYCLES_CORNER_NORMALS
+	const vector<V3f> &normals = static_cast<const V3fVectorData *>( n.data.get() )->readable();
+	const int *indices = n.indices ? n.indices->readable().data() : nullptr;
+	const std::vector<int> &offsets = topology->vertexCornerOffsets;
+	const std::vector<int> &corners = topology->vertexCorners;
+	const std::vector<int> *originalCorners = topology->triangulation ? &topology->triangulation->corners : nullptr;
+
+	std::atomic<bool> isVertex( true );
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, offsets.size() - 1 ),
+		[&]( const tbb::blocked_range<size_t> &r ) {
+			for( size_t v = r.begin(); v != r.end() && isVertex; ++v )
 			{
-				for( size_t j = 0; j < vertsPerFace[i]; ++j, ++vertex )
+				const V3f *first = nullptr;
+				for( int j = offsets[v]; j < offsets[v + 1]; ++j )
 				{
-					*(fdata++) = ccl::make_float2(uvs[vertexIds[vertex]].x, uvs[vertexIds[vertex]].y);
+					const int corner = originalCorners ? (*originalCorners)[corners[j]] : corners[j];
+					const V3f &normal = normals[indices ? indices[corner] : corner];
+					if( !first )
+					{
+						first = &normal;
+					}
+					else if( !first->equalWithAbsError( normal, g_vertexNormalTolerance ) )
+					{
+						isVertex = false;
+						break;
+					}
 				}
 			}
 		}
-		else // FaceVarying/Varying
-		{
-			for( size_t i = 0; i < numFaces; ++i )
+	);
+	return isVertex;
+#else
+	// Cycles has no per-corner normals, so vertex normals are the
+	// best we can do whatever the tolerance.
+	return true;
+#endif
+}
+
+// Writes face-varying normals as vertex normals, taking the normal for each
+// vertex from the first corner using it.
+void collapseNormals( const PrimitiveVariable &n, const Topology *topology, ccl::float3 *normals )
+{
+	const vector<V3f> &data = static_cast<const V3fVectorData *>( n.data.get() )->readable();
+	const int *indices = n.indices ? n.indices->readable().data() : nullptr;
+	const std::vector<int> &offsets = topology->vertexCornerOffsets;
+	const std::vector<int> &corners = topology->vertexCorners;
+	const std::vector<int> *originalCorners = topology->triangulation ? &topology->triangulation->corners : nullptr;
+
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, offsets.size() - 1 ),
+		[&]( const tbb::blocked_range<size_t> &r ) {
+			for( size_t v = r.begin(); v != r.end(); ++v )
 			{
-				for( size_t j = 0; j < vertsPerFace[i]; ++j, ++vertex )
+				V3f normal( 0.0f, 0.0f, 1.0f );
+				if( offsets[v] != offsets[v + 1] )
 				{
-					*(fdata++) = ccl::make_float2(uvs[vertex].x, uvs[vertex].y);
+					const int corner = originalCorners ? (*originalCorners)[corners[offsets[v]]] : corners[offsets[v]];
+					normal = data[indices ? indices[corner] : corner];
 				}
+				normals[v] = ccl::make_float3( normal.x, normal.y, normal.z );
 			}
 		}
-	}
+	);
 }
 
-ccl::Mesh *convertCommon( const IECoreScene::MeshPrimitive *mesh )
+// Sizes the Cycles arrays once, and then copies the cached topology into
+// them, rather than growing them a triangle at a time with `add_triangle()`.
+void convertTriangles( const IECoreScene::MeshPrimitive *mesh, const Topology *topology, ccl::Mesh *cmesh )
+{
+	const vector<Imath::V3f> &points = mesh->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex )->readable();
+
+	cmesh->resize_mesh( points.size(), topology->shader.size() );
+	convertVertices( points, cmesh );
+
+	std::copy( topology->triangles.begin(), topology->triangles.end(), cmesh->get_triangles().begin() );
+	std::copy( topology->shader.begin(), topology->shader.end(), cmesh->get_shader().begin() );
+	std::copy( topology->smooth.begin(), topology->smooth.end(), cmesh->get_smooth().begin() );
+	cmesh->tag_triangles_modified();
+	cmesh->tag_shader_modified();
+	cmesh->tag_smooth_modified();
+}
+
+ccl::Mesh *convertCommon( const IECoreScene::MeshPrimitive *mesh, bool generateNormals )
 {
 	assert( mesh->typeId() == IECoreScene::MeshPrimitive::staticTypeId() );
 	ccl::Mesh *cmesh = new ccl::Mesh();
 
+	if( !validVertexIds( mesh ) )
+	{
+		// An empty mesh, which renders nothing. Motion samples are
+		// rejected later, because their points don't match it.
+		return cmesh;
+	}
+
 	bool subdivision = false;
-	bool triangles = ( mesh->maxVerticesPerFace() == 3 ) ? true : false;
 
-	// If we need to convert
-	MeshPrimitivePtr trimesh;
+	// Shared with other meshes of the same topology, and null for
+	// subdivision meshes.
+	ConstTopologyPtr topology;
+	const Triangulation *triangulation = nullptr;
 
 	// Smooth/hard normals
-	bool smooth = true;
-	PrimitiveVariable::Interpolation sInterpolation = PrimitiveVariable::Invalid;
-	PrimitiveVariableMap::const_iterator sIt = mesh->variables.find( "_smooth" );
-	if( sIt != mesh->variables.end() )
-	{
-		if( sIt->second.interpolation == PrimitiveVariable::Constant ||
-			sIt->second.interpolation == PrimitiveVariable::Uniform )
-		{
-			sInterpolation = sIt->second.interpolation;
-		}
-		if( sInterpolation == PrimitiveVariable::Constant )
-		{
-			if( const BoolData *data = runTimeCast<const BoolData>( sIt->second.data.get() ) )
-			{
-				smooth = data->readable();
-			}
-		}
-	}
+	const bool smooth = defaultSmooth( mesh );
 
 	if( ( mesh->interpolation() == "catmullClark" ) )//|| !triangles )
 	{
@@ -691,9 +1254,8 @@ ccl::Mesh *convertCommon( const IECoreScene::MeshPrimitive *mesh )
 		const BoolVectorData *s = getSmooth( mesh );
 		const IntVectorData *f = getFaceset( mesh );
 
-		cmesh->reserve_mesh( numVerts, numFaces );
-		for( size_t i = 0; i < numVerts; i++ )
-			cmesh->add_vertex( ccl::make_float3( points[i].x, points[i].y, points[i].z ) );
+		cmesh->resize_mesh( numVerts, 0 );
+		convertVertices( points, cmesh );
 
 		const std::vector<int> &vertsPerFace = mesh->verticesPerFace()->readable();
 		size_t ngons = 0;
@@ -751,48 +1313,9 @@ ccl::Mesh *convertCommon( const IECoreScene::MeshPrimitive *mesh )
 	{
 		cmesh->set_subdivision_type( (mesh->interpolation() == "linear") ? ccl::Mesh::SUBDIVISION_LINEAR : ccl::Mesh::SUBDIVISION_NONE );
 
-		if( !triangles )
-		{
-			// triangulate primitive
-			trimesh = IECoreScene::MeshAlgo::triangulate( mesh );
-			const size_t numFaces = trimesh->numFaces();
-			const V3fVectorData *p = trimesh->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
-			const vector<Imath::V3f> &points = p->readable();
-			const size_t numVerts = points.size();
-			const std::vector<int> &triVertexIds = trimesh->vertexIds()->readable();
-			const BoolVectorData *s = getSmooth( trimesh.get() );
-			const IntVectorData *f = getFaceset( trimesh.get() );
-
-			const size_t triNumFaces = trimesh->numFaces();
-			cmesh->reserve_mesh( numVerts, triNumFaces );
-
-			for( size_t i = 0; i < numVerts; i++ )
-				cmesh->add_vertex( ccl::make_float3( points[i].x, points[i].y, points[i].z ) );
-
-			int faceOffset = 0;
-			for( size_t i = 0; i < triVertexIds.size(); i+= 3, ++faceOffset )
-				cmesh->add_triangle( triVertexIds[i], triVertexIds[i+1], triVertexIds[i+2], 
-					f ? f->readable()[faceOffset] : 0, s ? s->readable()[faceOffset] : smooth ); // Last two args are shader sets and smooth
-		}
-		else
-		{
-			const size_t numFaces = mesh->numFaces();
-			const V3fVectorData *p = mesh->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
-			const vector<Imath::V3f> &points = p->readable();
-			const vector<int> &vertexIds = mesh->vertexIds()->readable();
-			const size_t numVerts = points.size();
-			cmesh->reserve_mesh(numVerts, numFaces);
-			const BoolVectorData *s = getSmooth( mesh );
-			const IntVectorData *f = getFaceset( mesh );
-
-			for( size_t i = 0; i < numVerts; i++ )
-				cmesh->add_vertex( ccl::make_float3( points[i].x, points[i].y, points[i].z ) );
-
-			int faceOffset = 0;
-			for( size_t i = 0; i < vertexIds.size(); i+= 3, ++faceOffset )
-				cmesh->add_triangle( vertexIds[i], vertexIds[i+1], vertexIds[i+2], 
-					f ? f->readable()[faceOffset] : 0, s ? s->readable()[faceOffset] : smooth ); // Last two args are shader sets and smooth
-		}
+		topology = g_topologyCache.get( TopologyCacheGetterKey( mesh ) );
+		triangulation = topology->triangulation.get();
+		convertTriangles( mesh, topology.get(), cmesh );
 	}
 
 	// Primitive Variables are Attributes in Cycles
@@ -800,62 +1323,37 @@ ccl::Mesh *convertCommon( const IECoreScene::MeshPrimitive *mesh )
 
 	// Convert Normals
 	PrimitiveVariable::Interpolation nInterpolation = PrimitiveVariable::Invalid;
-	if( ( !triangles ) && ( mesh->interpolation() == "catmullClark" ) )
+	if( const PrimitiveVariable *validN = validNormal( mesh, nInterpolation ) )
 	{
-		if( const V3fVectorData *normals = normal( mesh, nInterpolation ) )
+		const PrimitiveVariable &n = *validN;
+		if( nInterpolation == PrimitiveVariable::FaceVarying && topology && normalsAreVertex( n, topology.get() ) )
 		{
-			ccl::Attribute *attr_N = attributes.add( normalAttributeStandard( nInterpolation ) );
-			convertN( mesh, normals, attr_N, nInterpolation );
-		}
-	}
-	else if( !triangles )
-	{
-		if( const V3fVectorData *normals = normal( trimesh.get(), nInterpolation ) )
-		{
-			ccl::Attribute *attr_N = attributes.add( normalAttributeStandard( nInterpolation ) );
-			convertN( trimesh.get(), normals, attr_N, nInterpolation );
+			ccl::Attribute *attr_N = attributes.add( ccl::ATTR_STD_VERTEX_NORMAL );
+			collapseNormals( n, topology.get(), attr_N->data_float3() );
+#ifdef WITH_CYCLES_CORNER_NORMALS
+			const size_t saved = ( topology->triangles.size() - cmesh->get_verts().size() ) * sizeof( ccl::float3 );
+			msg( Msg::Debug, "IECoreCycles::MeshAlgo", boost::format( "Converted face-varying \"N\" to vertex normals, saving %d bytes." ) % saved );
+#endif
 		}
 		else
 		{
-			IECoreScene::MeshNormalsOpPtr normalOp = new IECoreScene::MeshNormalsOp();
-			normalOp->inputParameter()->setValue( trimesh );
-			normalOp->copyParameter()->setTypedValue( false );
-			normalOp->operate();
-			if( const V3fVectorData *normals = normal( trimesh.get(), nInterpolation ) )
+			ccl::Attribute *attr_N = attributes.add( normalAttributeStandard( nInterpolation ) );
+			if( !convertN( mesh, n, attr_N->data_float3(), attr_N->buffer.size() / sizeof( ccl::float3 ), triangulation ) )
 			{
-				ccl::Attribute *attr_N = attributes.add( normalAttributeStandard( nInterpolation ) );
-				convertN( trimesh.get(), normals, attr_N, nInterpolation );
+				attributes.remove( attr_N );
 			}
 		}
 	}
-	else
+	else if( topology && ( generateNormals || !allSmooth( mesh ) ) )
 	{
-		if( const V3fVectorData *normals = normal( mesh, nInterpolation ) )
-		{
-			ccl::Attribute *attr_N = attributes.add( normalAttributeStandard( nInterpolation ) );
-			convertN( mesh, normals, attr_N, nInterpolation );
-		}
-		else if( mesh->interpolation() != "catmullClark" )
-		{
-			IECoreScene::MeshPrimitivePtr normalmesh = mesh->copy();
-			IECoreScene::MeshNormalsOpPtr normalOp = new IECoreScene::MeshNormalsOp();
-			normalOp->inputParameter()->setValue( normalmesh );
-			normalOp->copyParameter()->setTypedValue( false );
-			normalOp->operate();
-			if( const V3fVectorData *normals = normal( normalmesh.get(), nInterpolation ) )
-			{
-				ccl::Attribute *attr_N = attributes.add( normalAttributeStandard( nInterpolation ) );
-				convertN( normalmesh.get(), normals, attr_N, nInterpolation );
-			}
-		}
+		// Cycles would compute smooth vertex normals itself, so we can
+		// only skip this when asked to and every face is smooth.
+		ccl::Attribute *attr_N = attributes.add( ccl::ATTR_STD_VERTEX_NORMAL );
+		computeNormals( mesh->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex )->readable(), topology.get(), attr_N->data_float3() );
 	}
 
 	// Convert primitive variables.
-	PrimitiveVariableMap variablesToConvert;
-	if( subdivision || triangles )
-		variablesToConvert = mesh->variables;
-	else
-		variablesToConvert = trimesh->variables;
+	PrimitiveVariableMap variablesToConvert = mesh->variables;
 	variablesToConvert.erase( "P" ); // P is already done.
 	variablesToConvert.erase( "N" ); // As well as N.
 	variablesToConvert.erase( "_smooth" ); // Was already processed (if it existed)
@@ -901,14 +1399,14 @@ ccl::Mesh *convertCommon( const IECoreScene::MeshPrimitive *mesh )
 	}
 	if( rank != -1 )
 	{
-		convertUVSet( g_defautUVsetCandidates[rank], uvsets[g_defautUVsetCandidates[rank]], ( subdivision || triangles ) ? mesh : trimesh.get(), attributes, subdivision, true );
+		convertUVSet( g_defautUVsetCandidates[rank], uvsets[g_defautUVsetCandidates[rank]], mesh, triangulation, attributes, subdivision, true );
 		uvsets.erase( g_defautUVsetCandidates[rank] );
 	}
 
 	for( auto it = uvsets.begin(); it != uvsets.end(); )
 	{
 		// If we didn't find a default UVset, the first one we find will be the one.
-		convertUVSet( it->first, it->second, ( subdivision || triangles ) ? mesh : trimesh.get(), attributes, subdivision, (rank == -1) ? true : false );
+		convertUVSet( it->first, it->second, mesh, triangulation, attributes, subdivision, (rank == -1) ? true : false );
 		// Just set rank to not be -1 so that the next UVs are not converted as a default one.
 		rank = 0;
 		uvsets.erase( it );
@@ -918,11 +1416,187 @@ ccl::Mesh *convertCommon( const IECoreScene::MeshPrimitive *mesh )
 	// Finally, do a generic conversion of anything that remains.
 	for( PrimitiveVariableMap::iterator it = variablesToConvert.begin(), eIt = variablesToConvert.end(); it != eIt; ++it )
 	{
-		AttributeAlgo::convertPrimitiveVariable( it->first, it->second, attributes );
+		if( triangulation )
+		{
+			AttributeAlgo::convertPrimitiveVariable( it->first, triangulatedVariable( it->second, *triangulation ), attributes );
+		}
+		else
+		{
+			AttributeAlgo::convertPrimitiveVariable( it->first, it->second, attributes );
+		}
 	}
 	return cmesh;
 }
 
+//////////////////////////////////////////////////////////////////////////
+// Motion
+//////////////////////////////////////////////////////////////////////////
+
+// A sample for `motion_P` and `motion_N`. When `b` is given, the sample is
+// interpolated halfway between `a` and `b` as it is written to Cycles,
+// rather than being built as an interpolated copy of the mesh.
+struct MotionSample
+{
+	const IECoreScene::MeshPrimitive *a;
+	const IECoreScene::MeshPrimitive *b;
+};
+
+// How the normals of the reference sample were converted.
+enum class NormalSource
+{
+	None,
+	Variable,
+	Collapsed,
+	Generated
+};
+
+// Returns "P" if it is suitable for a motion sample with `numVerts` vertices,
+// warning and returning null otherwise.
+const V3fVectorData *motionPositions( const IECoreScene::MeshPrimitive *mesh, size_t numVerts )
+{
+	PrimitiveVariableMap::const_iterator pIt = mesh->variables.find( "P" );
+	if( pIt == mesh->variables.end() )
+	{
+		return nullptr;
+	}
+
+	const V3fVectorData *p = runTimeCast<const V3fVectorData>( pIt->second.data.get() );
+	if( !p )
+	{
+		msg( Msg::Warning, "IECoreCyles::MeshAlgo::convert", boost::format( "Variable \"Position\" has unsupported type \"%s\" (expected V3fVectorData)." ) % pIt->second.data->typeName() );
+		return nullptr;
+	}
+
+	if( pIt->second.interpolation != PrimitiveVariable::Vertex && pIt->second.interpolation != PrimitiveVariable::Varying )
+	{
+		msg( Msg::Warning, "IECoreCyles::MeshAlgo::convert", "Variable \"Position\" has unsupported interpolation type - not generating sampled Position." );
+		return nullptr;
+	}
+
+	if( p->readable().size() != numVerts )
+	{
+		msg( Msg::Warning, "IECoreCyles::MeshAlgo::convert", "Variable \"Position\" has inconsistent size between motion samples - not generating sampled Position." );
+		return nullptr;
+	}
+
+	return p;
+}
+
+void writePositions( const vector<V3f> &a, const vector<V3f> *b, ccl::float3 *out )
+{
+	if( b )
+	{
+		PackingAlgo::packAverage( a.data(), b->data(), out, a.size() );
+	}
+	else
+	{
+		PackingAlgo::pack( a.data(), out, a.size() );
+	}
+}
+
+// Writes `numNormals` normals for `mesh`, returning false if they
+// couldn't be written.
+bool writeNormals( const IECoreScene::MeshPrimitive *mesh, NormalSource source, PrimitiveVariable::Interpolation nInterpolation, size_t numNormals, ccl::float3 *out )
+{
+	ConstTopologyPtr topology;
+	if( mesh->interpolation() != "catmullClark" )
+	{
+		if( !validVertexIds( mesh ) )
+		{
+			return false;
+		}
+		topology = g_topologyCache.get( TopologyCacheGetterKey( mesh ) );
+	}
+
+	if( source == NormalSource::Generated )
+	{
+		computeNormals( mesh->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex )->readable(), topology.get(), out );
+		return true;
+	}
+
+	const PrimitiveVariable *validN = validNormal( mesh, nInterpolation );
+	if( !validN )
+	{
+		return false;
+	}
+
+	const PrimitiveVariable &n = *validN;
+	if( source == NormalSource::Collapsed )
+	{
+		collapseNormals( n, topology.get(), out );
+		return true;
+	}
+
+	return convertN( mesh, n, out, numNormals, topology ? topology->triangulation.get() : nullptr );
+}
+
+// Returns true if normals can be written for `mesh` in the same form and
+// number as they were converted for `reference`. Normals are written
+// straight into buffers sized for the reference, so this must hold for
+// every sample before any are written.
+bool normalsMatch( const IECoreScene::MeshPrimitive *mesh, const IECoreScene::MeshPrimitive *reference, NormalSource source, PrimitiveVariable::Interpolation nInterpolation )
+{
+	if( mesh == reference )
+	{
+		return true;
+	}
+
+	// The same number of vertices and the same face sizes give the same
+	// number of vertices, faces, corners and triangles.
+	const IntVectorData *verticesPerFace = mesh->verticesPerFace();
+	const IntVectorData *referenceVerticesPerFace = reference->verticesPerFace();
+	if(
+		mesh->variableSize( PrimitiveVariable::Vertex ) != reference->variableSize( PrimitiveVariable::Vertex ) ||
+		mesh->interpolation() != reference->interpolation() ||
+		( verticesPerFace != referenceVerticesPerFace && verticesPerFace->readable() != referenceVerticesPerFace->readable() )
+	)
+	{
+		return false;
+	}
+
+	if( mesh->interpolation() != "catmullClark" && !validVertexIds( mesh ) )
+	{
+		return false;
+	}
+
+	return source == NormalSource::Generated || validNormal( mesh, nInterpolation );
+}
+
+// Writes `numNormals` normals for `sample`, in the same form as they were
+// converted for the reference sample. Interpolated normals are renormalised,
+// since the average of two unit vectors is shorter than unit length. Returns
+// false if the normals couldn't be written.
+bool writeNormals( const MotionSample &sample, NormalSource source, PrimitiveVariable::Interpolation nInterpolation, size_t numNormals, ccl::float3 *out )
+{
+	if( !writeNormals( sample.a, source, nInterpolation, numNormals, out ) )
+	{
+		return false;
+	}
+
+	if( !sample.b )
+	{
+		return true;
+	}
+
+	ccl::array<ccl::float3> b( numNormals );
+	if( !writeNormals( sample.b, source, nInterpolation, numNormals, b.data() ) )
+	{
+		return false;
+	}
+
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, numNormals ),
+		[&]( const tbb::blocked_range<size_t> &r ) {
+			for( size_t i = r.begin(); i != r.end(); ++i )
+			{
+				out[i] = ccl::safe_normalize( out[i] + b[i] );
+			}
+		}
+	);
+
+	return true;
+}
+
 ObjectAlgo::ConverterDescription<MeshPrimitive> g_description( IECoreCycles::MeshAlgo::convert, IECoreCycles::MeshAlgo::convert );
 
 } // namespace
@@ -940,113 +1614,99 @@ namespace MeshAlgo
 {
 
 ccl::Object *convert( const IECoreScene::MeshPrimitive *mesh, const std::string &nodeName, ccl::Scene *scene )
+{
+	return convert( mesh, true, nodeName, scene );
+}
+
+ccl::Object *convert( const std::vector<const IECoreScene::MeshPrimitive *> &meshes, const std::vector<float> &times, const int frameIdx, const std::string &nodeName, ccl::Scene *scene )
+{
+	return convert( meshes, times, frameIdx, true, nodeName, scene );
+}
+
+ccl::Object *convert( const IECoreScene::MeshPrimitive *mesh, bool generateNormals, const std::string &nodeName, ccl::Scene *scene )
 {
 	ccl::Object *cobject = new ccl::Object();
-	cobject->set_geometry( static_cast<ccl::Geometry*>( convertCommon( mesh ) ) );
+	cobject->set_geometry( static_cast<ccl::Geometry*>( convertCommon( mesh, generateNormals ) ) );
 	cobject->name = ccl::ustring(nodeName.c_str());
 	return cobject;
 }
 
-ccl::Object *convert( const std::vector<const IECoreScene::MeshPrimitive *> &meshes, const std::vector<float> &times, const int frameIdx, const std::string &nodeName, ccl::Scene *scene )
+ccl::Object *convert( const std::vector<const IECoreScene::MeshPrimitive *> &meshes, const std::vector<float> &times, const int frameIdx, bool generateNormals, const std::string &nodeName, ccl::Scene *scene )
 {
 	const int numSamples = meshes.size();
 
-	ccl::Mesh *cmesh = nullptr;
-	std::vector<const IECoreScene::MeshPrimitive *> samples;
-	IECoreScene::MeshPrimitivePtr midMesh;
+	std::vector<MotionSample> samples;
+	MotionSample reference = { nullptr, nullptr };
 
 	if( frameIdx != -1 ) // Start/End frames
 	{
-		cmesh = convertCommon(meshes[frameIdx]);
+		reference.a = meshes[frameIdx];
 
 		if( numSamples == 2 ) // Make sure we have 3 samples
 		{
-			const V3fVectorData *p1 = meshes[0]->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
-			const V3fVectorData *p2 = meshes[1]->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
-			if( p1 && p2 )
-			{
-				midMesh = meshes[frameIdx]->copy();
-				V3fVectorData *midP = midMesh->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
-				IECore::LinearInterpolator<std::vector<V3f>>()( p1->readable(), p2->readable(), 0.5f, midP->writable() );
-
-				PrimitiveVariable::Interpolation nInterpolation = PrimitiveVariable::Invalid;
-				if( normal( meshes[0], nInterpolation ) )
-				{
-					const V3fVectorData *n1 = meshes[0]->variableData<V3fVectorData>( "N", nInterpolation );
-					const V3fVectorData *n2 = meshes[1]->variableData<V3fVectorData>( "N", nInterpolation );
-					V3fVectorData *midN = midMesh->variableData<V3fVectorData>( "N", nInterpolation );
-					IECore::LinearInterpolator<std::vector<V3f>>()( n1->readable(), n2->readable(), 0.5f, midN->writable() );
-				}
-
-				samples.push_back( midMesh.get() );
-			}
+			samples.push_back( { meshes[0], meshes[1] } );
 		}
 
 		for( int i = 0; i < numSamples; ++i )
 		{
 			if( i == frameIdx )
 				continue;
-			samples.push_back( meshes[i] );
+			samples.push_back( { meshes[i], nullptr } );
 		}
 	}
 	else if( numSamples % 2 ) // Odd numSamples
 	{
 		int _frameIdx = numSamples / 2;
-		cmesh = convertCommon(meshes[_frameIdx]);
+		reference.a = meshes[_frameIdx];
 
 		for( int i = 0; i < numSamples; ++i )
 		{
 			if( i == _frameIdx )
 				continue;
-			samples.push_back( meshes[i] );
+			samples.push_back( { meshes[i], nullptr } );
 		}
 	}
 	else // Even numSamples
 	{
 		int _frameIdx = numSamples / 2 - 1;
-		const V3fVectorData *p1 = meshes[_frameIdx]->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
-		const V3fVectorData *p2 = meshes[_frameIdx+1]->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
-		if( p1 && p2 )
-		{
-			midMesh = meshes[_frameIdx]->copy();
-			V3fVectorData *midP = midMesh->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
-			IECore::LinearInterpolator<std::vector<V3f>>()( p1->readable(), p2->readable(), 0.5f, midP->writable() );
-
-			PrimitiveVariable::Interpolation nInterpolation = PrimitiveVariable::Invalid;
-			if( normal( meshes[0], nInterpolation ) )
-			{
-				const V3fVectorData *n1 = meshes[0]->variableData<V3fVectorData>( "N", nInterpolation );
-				const V3fVectorData *n2 = meshes[1]->variableData<V3fVectorData>( "N", nInterpolation );
-				V3fVectorData *midN = midMesh->variableData<V3fVectorData>( "N", nInterpolation );
-				IECore::LinearInterpolator<std::vector<V3f>>()( n1->readable(), n2->readable(), 0.5f, midN->writable() );
-			}
-
-			cmesh = convertCommon( midMesh.get() );
-		}
+		reference = { meshes[_frameIdx], meshes[_frameIdx+1] };
 
 		for( int i = 0; i < numSamples; ++i )
 		{
-			samples.push_back( meshes[i] );
+			samples.push_back( { meshes[i], nullptr } );
 		}
 	}
 
-	// Add the motion position/normal attributes
-	cmesh->set_use_motion_blur( true );
-	cmesh->set_motion_steps( samples.size() + 1 );
-	ccl::Attribute *attr_mP = cmesh->attributes.add( ccl::ATTR_STD_MOTION_VERTEX_POSITION, ccl::ustring("motion_P") );
-	ccl::float3 *mP = attr_mP->data_float3();
-	ccl::Attribute *attr_mN = nullptr;
+	ccl::Mesh *cmesh = convertCommon( reference.a, generateNormals );
+	const size_t numVerts = cmesh->get_verts().size();
+
+	// Find out how the normals were converted for the reference sample,
+	// so that we can convert them the same way for the motion samples.
+	ccl::AttributeSet &attributes = cmesh->get_num_subd_faces() ? cmesh->subd_attributes : cmesh->attributes;
+	NormalSource normalSource = NormalSource::None;
+	ccl::Attribute *attr_N = nullptr;
+	ccl::AttributeStandard motionNormalStandard = ccl::ATTR_STD_MOTION_VERTEX_NORMAL;
+	ccl::ustring motionNormalName( "motion_N" );
 	PrimitiveVariable::Interpolation nInterpolation = PrimitiveVariable::Invalid;
-	if( normal( meshes[0], nInterpolation ) )
+	if( validNormal( reference.a, nInterpolation ) )
 	{
 		if( nInterpolation == PrimitiveVariable::Vertex )
 		{
-			attr_mN = cmesh->attributes.add( ccl::ATTR_STD_MOTION_VERTEX_NORMAL, ccl::ustring("motion_N") );
+			attr_N = attributes.find( ccl::ATTR_STD_VERTEX_NORMAL );
+			normalSource = NormalSource::Variable;
+		}
+		else if( nInterpolation == PrimitiveVariable::FaceVarying && attributes.find( ccl::ATTR_STD_VERTEX_NORMAL ) )
+		{
+			attr_N = attributes.find( ccl::ATTR_STD_VERTEX_NORMAL );
+			normalSource = NormalSource::Collapsed;
 		}
 #ifdef WITH_CYCLES_CORNER_NORMALS
 		else if( nInterpolation == PrimitiveVariable::FaceVarying )
 		{
-			attr_mN = cmesh->attributes.add( ccl::ATTR_STD_MOTION_CORNER_NORMAL, ccl::ustring("motion_Nc") );
+			attr_N = attributes.find( ccl::ATTR_STD_CORNER_NORMAL );
+			motionNormalStandard = ccl::ATTR_STD_MOTION_CORNER_NORMAL;
+			motionNormalName = ccl::ustring( "motion_Nc" );
+			normalSource = NormalSource::Variable;
 		}
 #endif
 		else
@@ -1054,49 +1714,84 @@ ccl::Object *convert( const std::vector<const IECoreScene::MeshPrimitive *> &mes
 			msg( Msg::Warning, "IECoreCyles::MeshAlgo::convert", "Variable \"N\" has unsupported interpolation type for motion steps - not generating normals." );
 		}
 	}
+	else if( ( attr_N = attributes.find( ccl::ATTR_STD_VERTEX_NORMAL ) ) )
+	{
+		normalSource = NormalSource::Generated;
+	}
 
-	for( size_t i = 0; i < samples.size(); ++i )
+	if( !attr_N )
 	{
-		PrimitiveVariableMap::const_iterator pIt = samples[i]->variables.find( "P" );
-		if( pIt != samples[i]->variables.end() )
+		normalSource = NormalSource::None;
+	}
+
+	if( normalSource != NormalSource::None )
+	{
+		bool match = !reference.b || normalsMatch( reference.b, reference.a, normalSource, nInterpolation );
+		for( size_t i = 0; i < samples.size() && match; ++i )
 		{
-			const V3fVectorData *p = runTimeCast<const V3fVectorData>( pIt->second.data.get() );
-			if( p )
-			{
-				PrimitiveVariable::Interpolation pInterpolation = pIt->second.interpolation;
-				if( pInterpolation == PrimitiveVariable::Varying || pInterpolation == PrimitiveVariable::Vertex || pInterpolation == PrimitiveVariable::FaceVarying )
-				{
-					// Vertex positions
-					const V3fVectorData *p = samples[i]->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
-					const std::vector<V3f> &points = p->readable();
-					size_t numVerts = p->readable().size();
+			match =
+				normalsMatch( samples[i].a, reference.a, normalSource, nInterpolation ) &&
+				( !samples[i].b || normalsMatch( samples[i].b, reference.a, normalSource, nInterpolation ) )
+			;
+		}
+		if( !match )
+		{
+			msg( Msg::Warning, "IECoreCyles::MeshAlgo::convert", "Variable \"N\" or topology is inconsistent between motion samples - not generating sampled normals." );
+			normalSource = NormalSource::None;
+		}
+	}
 
-					for( size_t j = 0; j < numVerts; ++j, ++mP )
-						*mP = ccl::make_float3( points[j].x, points[j].y, points[j].z );
-				}
-				else
-				{
-					msg( Msg::Warning, "IECoreCyles::MeshAlgo::convert", "Variable \"Position\" has unsupported interpolation type - not generating sampled Position." );
-					cmesh->attributes.remove( attr_mP );
-					cmesh->set_motion_steps( 0 );
-					cmesh->set_use_motion_blur( false );
-				}
-			}
-			else
+	const size_t numNormals = attr_N ? attr_N->buffer.size() / sizeof( ccl::float3 ) : 0;
+
+	if( reference.b )
+	{
+		// Interpolate the reference sample in place.
+		const V3fVectorData *p1 = reference.a->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
+		const V3fVectorData *p2 = motionPositions( reference.b, numVerts );
+		if( p2 )
+		{
+			writePositions( p1->readable(), &p2->readable(), cmesh->get_verts().data() );
+			cmesh->tag_verts_modified();
+			if( normalSource != NormalSource::None )
 			{
-				msg( Msg::Warning, "IECoreCyles::MeshAlgo::convert", boost::format( "Variable \"Position\" has unsupported type \"%s\" (expected V3fVectorData)." ) % pIt->second.data->typeName() );
-				cmesh->attributes.remove( attr_mP );
-				cmesh->set_motion_steps( 0) ;
-				cmesh->set_use_motion_blur( true );
+				writeNormals( reference, normalSource, nInterpolation, numNormals, attr_N->data_float3() );
 			}
 		}
+	}
 
-		if( attr_mN )
+	// Add the motion position/normal attributes
+	cmesh->set_use_motion_blur( true );
+	cmesh->set_motion_steps( samples.size() + 1 );
+	ccl::Attribute *attr_mP = cmesh->attributes.add( ccl::ATTR_STD_MOTION_VERTEX_POSITION, ccl::ustring("motion_P") );
+	ccl::Attribute *attr_mN = nullptr;
+	if( normalSource != NormalSource::None )
+	{
+		attr_mN = cmesh->attributes.add( motionNormalStandard, motionNormalName );
+	}
+
+	for( size_t i = 0; i < samples.size(); ++i )
+	{
+		const V3fVectorData *p1 = motionPositions( samples[i].a, numVerts );
+		const V3fVectorData *p2 = samples[i].b ? motionPositions( samples[i].b, numVerts ) : nullptr;
+		if( !p1 || ( samples[i].b && !p2 ) )
 		{
-			if( const V3fVectorData *normals = normal( samples[i], nInterpolation ) )
+			cmesh->attributes.remove( attr_mP );
+			if( attr_mN )
 			{
-				convertN( samples[i], normals, attr_mN, nInterpolation );
+				cmesh->attributes.remove( attr_mN );
 			}
+			cmesh->set_motion_steps( 0 );
+			cmesh->set_use_motion_blur( false );
+			break;
+		}
+
+		writePositions( p1->readable(), p2 ? &p2->readable() : nullptr, attr_mP->data_float3() + i * numVerts );
+		if( attr_mN && !writeNormals( samples[i], normalSource, nInterpolation, numNormals, attr_mN->data_float3() + i * numNormals ) )
+		{
+			// Not expected after `normalsMatch()`, but partial normals
+			// are worse than none.
+			cmesh->attributes.remove( attr_mN );
+			attr_mN = nullptr;
 		}
 	}
 
@@ -1113,10 +1808,16 @@ void computeTangents( ccl::Mesh *cmesh, const IECoreScene::MeshPrimitive *mesh,
 
 	ccl::Attribute *attr = attributes.find( ccl::ATTR_STD_UV );
 	if( attr )
-		mikk_compute_tangents( attr->standard_name( ccl::ATTR_STD_UV ), cmesh, needsign, true );
+		mikk_compute_tangents( attr->name.c_str(), cmesh, needsign, true );
+}
+
+void computeTangents( ccl::Mesh *cmesh, const std::string &uvSet, bool needsign )
+{
+	const ccl::AttributeSet &attributes = (cmesh->get_num_subd_faces()) ? cmesh->subd_attributes :
+																		  cmesh->attributes;
 
-	// Secondary UVsets
-	// TODO: Currently seeing Cycles not working with normal maps and secondary UVs.
+	if( attributes.find( ccl::ustring( uvSet.c_str() ) ) )
+		mikk_compute_tangents( uvSet.c_str(), cmesh, needsign, false );
 }
 
 } // namespace MeshAlgo
@@ -0,0 +1,362 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2023, Alex Fuller. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include "PackingAlgo.h"
+
+#include "tbb/blocked_range.h"
+#include "tbb/parallel_for.h"
+
+#include <cassert>
+#include <cstring>
+
+#if defined( __x86_64__ ) || defined( _M_X64 )
+#define IECORECYCLES_PACKING_SIMD
+#include <immintrin.h>
+#endif
+
+// Cycles
+#include "util/system.h"
+
+// GCC and Clang only allow AVX2 intrinsics in functions targeting it,
+// whereas MSVC allows them anywhere.
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define IECORECYCLES_TARGET_AVX2 __attribute__(( target( "avx2" ) ))
+#else
+#define IECORECYCLES_TARGET_AVX2
+#endif
+
+using namespace Imath;
+using namespace IECoreCycles;
+
+namespace
+{
+
+// The kernels write whole registers into each destination element.
+static_assert( sizeof( ccl::float3 ) == 16, "Unexpected float3 layout" );
+
+// Each kernel converts elements [begin, end), with float3 sources
+// given as tightly packed triples.
+
+//////////////////////////////////////////////////////////////////////////
+// Scalar kernels
+//////////////////////////////////////////////////////////////////////////
+
+void packFloat3Scalar( const float *source, ccl::float3 *destination, size_t begin, size_t end )
+{
+	for( size_t i = begin; i < end; ++i )
+	{
+		const float *s = source + i * 3;
+		destination[i] = ccl::make_float3( s[0], s[1], s[2] );
+	}
+}
+
+void packAverageScalar( const float *a, const float *b, ccl::float3 *destination, size_t begin, size_t end )
+{
+	for( size_t i = begin; i < end; ++i )
+	{
+		const float *sa = a + i * 3;
+		const float *sb = b + i * 3;
+		destination[i] = ccl::make_float3( ( sa[0] + sb[0] ) * 0.5f, ( sa[1] + sb[1] ) * 0.5f, ( sa[2] + sb[2] ) * 0.5f );
+	}
+}
+
+void packIntScalar( const int *source, float *destination, size_t begin, size_t end )
+{
+	for( size_t i = begin; i < end; ++i )
+	{
+		destination[i] = (float)source[i];
+	}
+}
+
+#ifdef IECORECYCLES_PACKING_SIMD
+
+//////////////////////////////////////////////////////////////////////////
+// SSE2 kernels
+//////////////////////////////////////////////////////////////////////////
+
+// Loading a triple into a register reads one float past it, so the
+// last element of a range is always left to the scalar kernel. The
+// destinations are aligned, because `ccl::float3` is.
+
+__m128 padMask()
+{
+	return _mm_castsi128_ps( _mm_set_epi32( 0, -1, -1, -1 ) );
+}
+
+void packFloat3SSE2( const float *source, ccl::float3 *destination, size_t begin, size_t end )
+{
+	const __m128 mask = padMask();
+	size_t i = begin;
+	for( ; i + 1 < end; ++i )
+	{
+		_mm_store_ps( reinterpret_cast<float *>( destination + i ), _mm_and_ps( _mm_loadu_ps( source + i * 3 ), mask ) );
+	}
+	packFloat3Scalar( source, destination, i, end );
+}
+
+void packAverageSSE2( const float *a, const float *b, ccl::float3 *destination, size_t begin, size_t end )
+{
+	const __m128 mask = padMask();
+	const __m128 half = _mm_set1_ps( 0.5f );
+	size_t i = begin;
+	for( ; i + 1 < end; ++i )
+	{
+		const __m128 sum = _mm_add_ps( _mm_loadu_ps( a + i * 3 ), _mm_loadu_ps( b + i * 3 ) );
+		_mm_store_ps( reinterpret_cast<float *>( destination + i ), _mm_and_ps( _mm_mul_ps( sum, half ), mask ) );
+	}
+	packAverageScalar( a, b, destination, i, end );
+}
+
+void packIntSSE2( const int *source, float *destination, size_t begin, size_t end )
+{
+	size_t i = begin;
+	for( ; i + 4 <= end; i += 4 )
+	{
+		const __m128i v = _mm_loadu_si128( reinterpret_cast<const __m128i *>( source + i ) );
+		_mm_storeu_ps( destination + i, _mm_cvtepi32_ps( v ) );
+	}
+	packIntScalar( source, destination, i, end );
+}
+
+//////////////////////////////////////////////////////////////////////////
+// AVX2 kernels
+//////////////////////////////////////////////////////////////////////////
+
+// These convert two triples at a time, reading eight floats and
+// spreading them across the lanes of a register. Whatever remains is
+// left to the SSE2 kernels.
+
+IECORECYCLES_TARGET_AVX2 __m256 loadPair( const float *source )
+{
+	const __m256i spread = _mm256_setr_epi32( 0, 1, 2, 0, 3, 4, 5, 0 );
+	return _mm256_permutevar8x32_ps( _mm256_loadu_ps( source ), spread );
+}
+
+IECORECYCLES_TARGET_AVX2 void storePair( __m256 v, ccl::float3 *destination )
+{
+	_mm256_storeu_ps( reinterpret_cast<float *>( destination ), _mm256_blend_ps( v, _mm256_setzero_ps(), 0x88 ) );
+}
+
+IECORECYCLES_TARGET_AVX2 void packFloat3AVX2( const float *source, ccl::float3 *destination, size_t begin, size_t end )
+{
+	size_t i = begin;
+	for( ; i + 3 <= end; i += 2 )
+	{
+		storePair( loadPair( source + i * 3 ), destination + i );
+	}
+	packFloat3SSE2( source, destination, i, end );
+}
+
+IECORECYCLES_TARGET_AVX2 void packAverageAVX2( const float *a, const float *b, ccl::float3 *destination, size_t begin, size_t end )
+{
+	const __m256 half = _mm256_set1_ps( 0.5f );
+	size_t i = begin;
+	for( ; i + 3 <= end; i += 2 )
+	{
+		const __m256 sum = _mm256_add_ps( loadPair( a + i * 3 ), loadPair( b + i * 3 ) );
+		storePair( _mm256_mul_ps( sum, half ), destination + i );
+	}
+	packAverageSSE2( a, b, destination, i, end );
+}
+
+IECORECYCLES_TARGET_AVX2 void packIntAVX2( const int *source, float *destination, size_t begin, size_t end )
+{
+	size_t i = begin;
+	for( ; i + 8 <= end; i += 8 )
+	{
+		const __m256i v = _mm256_loadu_si256( reinterpret_cast<const __m256i *>( source + i ) );
+		_mm256_storeu_ps( destination + i, _mm256_cvtepi32_ps( v ) );
+	}
+	packIntSSE2( source, destination, i, end );
+}
+
+#endif // IECORECYCLES_PACKING_SIMD
+
+//////////////////////////////////////////////////////////////////////////
+// Dispatch
+//////////////////////////////////////////////////////////////////////////
+
+struct Kernels
+{
+	void (*packFloat3)( const float *, ccl::float3 *, size_t, size_t );
+	void (*packAverage)( const float *, const float *, ccl::float3 *, size_t, size_t );
+	void (*packInt)( const int *, float *, size_t, size_t );
+};
+
+#ifndef NDEBUG
+
+// Checks that the kernels match the scalar ones for every size up to
+// 9 and every begin offset up to 3, which covers each of the SIMD
+// loops and the tails left over from them.
+void checkKernels( const Kernels &k )
+{
+	const size_t maxBegin = 3;
+	const size_t maxSize = 9;
+	const size_t maxEnd = maxBegin + maxSize;
+
+	// Two extra triples, so that `b` can be offset from `a`.
+	float source[( maxEnd + 1 ) * 3];
+	int intSource[maxEnd];
+	for( size_t i = 0; i < ( maxEnd + 1 ) * 3; ++i )
+	{
+		source[i] = (float)i * 0.37f - 5.0f;
+	}
+	for( size_t i = 0; i < maxEnd; ++i )
+	{
+		intSource[i] = (int)( i * 7919 ) - 40000;
+	}
+
+	for( size_t begin = 0; begin <= maxBegin; ++begin )
+	{
+		for( size_t end = begin; end <= begin + maxSize; ++end )
+		{
+			ccl::float3 expected[maxEnd];
+			ccl::float3 actual[maxEnd];
+
+			memset( (void *)expected, 0, sizeof( expected ) );
+			memset( (void *)actual, 0, sizeof( actual ) );
+			packFloat3Scalar( source, expected, begin, end );
+			k.packFloat3( source, actual, begin, end );
+			assert( !memcmp( expected, actual, sizeof( expected ) ) );
+
+			memset( (void *)expected, 0, sizeof( expected ) );
+			memset( (void *)actual, 0, sizeof( actual ) );
+			packAverageScalar( source, source + 3, expected, begin, end );
+			k.packAverage( source, source + 3, actual, begin, end );
+			assert( !memcmp( expected, actual, sizeof( expected ) ) );
+
+			float expectedInt[maxEnd] = {};
+			float actualInt[maxEnd] = {};
+			packIntScalar( intSource, expectedInt, begin, end );
+			k.packInt( intSource, actualInt, begin, end );
+			assert( !memcmp( expectedInt, actualInt, sizeof( expectedInt ) ) );
+		}
+	}
+}
+
+#endif // NDEBUG
+
+Kernels chooseKernels()
+{
+#ifdef IECORECYCLES_PACKING_SIMD
+	// SSE2 is always available on x86_64.
+	const Kernels k = ccl::system_cpu_support_avx2() ?
+		Kernels { packFloat3AVX2, packAverageAVX2, packIntAVX2 } :
+		Kernels { packFloat3SSE2, packAverageSSE2, packIntSSE2 }
+	;
+#else
+	const Kernels k = { packFloat3Scalar, packAverageScalar, packIntScalar };
+#endif
+
+#ifndef NDEBUG
+	checkKernels( k );
+#endif
+
+	return k;
+}
+
+const Kernels &kernels()
+{
+	static const Kernels k = chooseKernels();
+	return k;
+}
+
+// Large enough that each task is dominated by copying rather than
+// scheduling, and that the tails left to the scalar kernels are rare.
+const size_t g_grainSize = 4096;
+
+template<typename Kernel>
+void parallelPack( size_t size, Kernel &&kernel )
+{
+	tbb::parallel_for(
+		tbb::blocked_range<size_t>( 0, size, g_grainSize ),
+		[&]( const tbb::blocked_range<size_t> &r ) {
+			kernel( r.begin(), r.end() );
+		}
+	);
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// Implementation of public API
+//////////////////////////////////////////////////////////////////////////
+
+namespace IECoreCycles
+
+{
+
+namespace PackingAlgo
+
+{
+
+void pack( const Imath::V3f *source, ccl::float3 *destination, size_t size )
+{
+	const auto kernel = kernels().packFloat3;
+	parallelPack( size, [&]( size_t begin, size_t end ) { kernel( &source->x, destination, begin, end ); } );
+}
+
+void pack( const Imath::Color3f *source, ccl::float3 *destination, size_t size )
+{
+	const auto kernel = kernels().packFloat3;
+	parallelPack( size, [&]( size_t begin, size_t end ) { kernel( &source->x, destination, begin, end ); } );
+}
+
+void pack( const Imath::Color4f *source, ccl::float4 *destination, size_t size )
+{
+	// The layouts already match, so this is a straight copy.
+	static_assert( sizeof( Imath::Color4f ) == sizeof( ccl::float4 ), "Unexpected float4 layout" );
+	parallelPack( size, [&]( size_t begin, size_t end ) { memcpy( (void *)( destination + begin ), source + begin, ( end - begin ) * sizeof( ccl::float4 ) ); } );
+}
+
+void pack( const float *source, float *destination, size_t size )
+{
+	parallelPack( size, [&]( size_t begin, size_t end ) { memcpy( destination + begin, source + begin, ( end - begin ) * sizeof( float ) ); } );
+}
+
+void pack( const int *source, float *destination, size_t size )
+{
+	const auto kernel = kernels().packInt;
+	parallelPack( size, [&]( size_t begin, size_t end ) { kernel( source, destination, begin, end ); } );
+}
+
+void packAverage( const Imath::V3f *a, const Imath::V3f *b, ccl::float3 *destination, size_t size )
+{
+	const auto kernel = kernels().packAverage;
+	parallelPack( size, [&]( size_t begin, size_t end ) { kernel( &a->x, &b->x, destination, begin, end ); } );
+}
+
+} // namespace PackingAlgo
+
+} // namespace IECoreCycles
@@ -0,0 +1,67 @@
+//////////////////////////////////////////////////////////////////////////
+//
+//  Copyright (c) 2023, Alex Fuller. All rights reserved.
+//
+//  Redistribution and use in source and binary forms, with or without
+//  modification, are permitted provided that the following conditions are
+//  met:
+//
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//
+//     * Neither the name of Image Engine Design nor the names of any
+//       other contributors to this software may be used to endorse or
+//       promote products derived from this software without specific prior
+//       written permission.
+//
+//  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+//  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+//  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+//  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+//  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+//  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+//  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+//  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+//  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+//  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+//  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef IECORECYCLES_PACKINGALGO_H
+#define IECORECYCLES_PACKINGALGO_H
+
+#include "IECore/VectorTypedData.h"
+
+// Cycles
+#include "util/types.h"
+
+namespace IECoreCycles
+{
+
+/// Internal kernels for copying tightly packed Cortex data into the
+/// padded types used by Cycles. All functions run in parallel, and use
+/// SSE2 or AVX2 kernels chosen at runtime according to the CPU. The
+/// padding component of each `ccl::float3` is written as zero, so that
+/// the results compare equal when Cycles checks arrays for changes.
+namespace PackingAlgo
+{
+
+void pack( const Imath::V3f *source, ccl::float3 *destination, size_t size );
+void pack( const Imath::Color3f *source, ccl::float3 *destination, size_t size );
+void pack( const Imath::Color4f *source, ccl::float4 *destination, size_t size );
+void pack( const float *source, float *destination, size_t size );
+void pack( const int *source, float *destination, size_t size );
+
+/// Packs the average of `a` and `b`, as needed for motion mid-samples.
+void packAverage( const Imath::V3f *a, const Imath::V3f *b, ccl::float3 *destination, size_t size );
+
+} // namespace PackingAlgo
+
+} // namespace IECoreCycles
+
+#endif // IECORECYCLES_PACKINGALGO_H
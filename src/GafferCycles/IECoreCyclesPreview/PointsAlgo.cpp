@@ -38,9 +38,10 @@
 #include "GafferCycles/IECoreCyclesPreview/ObjectAlgo.h"
 #include "GafferCycles/IECoreCyclesPreview/SocketAlgo.h"
 
+#include "PackingAlgo.h"
+
 #include "IECoreScene/PointsPrimitive.h"
 
-#include "IECore/Interpolator.h"
 #include "IECore/MessageHandler.h"
 #include "IECore/SimpleTypedData.h"
 
@@ -57,6 +58,23 @@ using namespace IECoreCycles;
 namespace
 {
 
+// A motion sample. When the second primitive is given, the sample is
+// interpolated halfway between the two as it is written to Cycles,
+// rather than being built as an interpolated copy of the primitive.
+typedef std::pair<const IECoreScene::PointsPrimitive *, const IECoreScene::PointsPrimitive *> MotionSample;
+
+void writePositions( const vector<V3f> &p1, const vector<V3f> *p2, ccl::float3 *out )
+{
+	if( p2 )
+	{
+		PackingAlgo::packAverage( p1.data(), p2->data(), out, p1.size() );
+	}
+	else
+	{
+		PackingAlgo::pack( p1.data(), out, p1.size() );
+	}
+}
+
 ccl::PointCloud *convertCommon( const IECoreScene::PointsPrimitive *points )
 {
 	assert( points->typeId() == IECoreScene::PointsPrimitive::staticTypeId() );
@@ -169,8 +187,7 @@ ccl::Object *convert( const vector<const IECoreScene::PointsPrimitive *> &points
 	const int numSamples = points.size();
 
 	ccl::PointCloud *pointcloud = nullptr;
-	std::vector<const IECoreScene::PointsPrimitive *> samples;
-	IECoreScene::PointsPrimitivePtr midMesh;
+	std::vector<MotionSample> samples;
 
 	if( frameIdx != -1 ) // Start/End frames
 	{
@@ -180,13 +197,9 @@ ccl::Object *convert( const vector<const IECoreScene::PointsPrimitive *> &points
 		{
 			const V3fVectorData *p1 = points[0]->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
 			const V3fVectorData *p2 = points[1]->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
-			if( p1 && p2 )
+			if( p1 && p2 && p1->readable().size() == p2->readable().size() )
 			{
-				midMesh = points[frameIdx]->copy();
-				V3fVectorData *midP = midMesh->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
-				IECore::LinearInterpolator<std::vector<V3f>>()( p1->readable(), p2->readable(), 0.5f, midP->writable() );
-
-				samples.push_back( midMesh.get() );
+				samples.push_back( MotionSample( points[0], points[1] ) );
 			}
 		}
 
@@ -194,19 +207,19 @@ ccl::Object *convert( const vector<const IECoreScene::PointsPrimitive *> &points
 		{
 			if( i == frameIdx )
 				continue;
-			samples.push_back( points[i] );
+			samples.push_back( MotionSample( points[i], nullptr ) );
 		}
 	}
 	else if( numSamples % 2 ) // Odd numSamples
 	{
-		int _frameIdx = ( numSamples+1 ) / 2;
+		int _frameIdx = numSamples / 2;
 		pointcloud = convertCommon( points[_frameIdx] );
 
 		for( int i = 0; i < numSamples; ++i )
 		{
 			if( i == _frameIdx )
 				continue;
-			samples.push_back( points[i] );
+			samples.push_back( MotionSample( points[i], nullptr ) );
 		}
 	}
 	else // Even numSamples
@@ -214,17 +227,17 @@ ccl::Object *convert( const vector<const IECoreScene::PointsPrimitive *> &points
 		int _frameIdx = numSamples / 2 - 1;
 		const V3fVectorData *p1 = points[_frameIdx]->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
 		const V3fVectorData *p2 = points[_frameIdx+1]->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
-		if( p1 && p2 )
+		pointcloud = convertCommon( points[_frameIdx] );
+		if( p1 && p2 && p1->readable().size() == p2->readable().size() )
 		{
-			midMesh = points[_frameIdx]->copy();
-			V3fVectorData *midP = midMesh->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
-			IECore::LinearInterpolator<std::vector<V3f>>()( p1->readable(), p2->readable(), 0.5f, midP->writable() );
-			pointcloud = convertCommon( midMesh.get() );
+			// Interpolate the reference sample in place.
+			writePositions( p1->readable(), &p2->readable(), pointcloud->get_points().data() );
+			pointcloud->tag_points_modified();
 		}
 
 		for( int i = 0; i < numSamples; ++i )
 		{
-			samples.push_back( points[i] );
+			samples.push_back( MotionSample( points[i], nullptr ) );
 		}
 	}
 
@@ -236,8 +249,8 @@ ccl::Object *convert( const vector<const IECoreScene::PointsPrimitive *> &points
 
 	for( size_t i = 0; i < samples.size(); ++i )
 	{
-		PrimitiveVariableMap::const_iterator pIt = samples[i]->variables.find( "P" );
-		if( pIt != samples[i]->variables.end() )
+		PrimitiveVariableMap::const_iterator pIt = samples[i].first->variables.find( "P" );
+		if( pIt != samples[i].first->variables.end() )
 		{
 			const V3fVectorData *p = runTimeCast<const V3fVectorData>( pIt->second.data.get() );
 			if( p )
@@ -246,12 +259,9 @@ ccl::Object *convert( const vector<const IECoreScene::PointsPrimitive *> &points
 				if( pInterpolation == PrimitiveVariable::Varying || pInterpolation == PrimitiveVariable::Vertex || pInterpolation == PrimitiveVariable::FaceVarying )
 				{
 					// Vertex positions
-					const V3fVectorData *p = samples[i]->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex );
-					const std::vector<V3f> &points = p->readable();
-					size_t numVerts = p->readable().size();
-
-					for( size_t j = 0; j < numVerts; ++j, ++mP )
-						*mP = ccl::make_float3( points[j].x, points[j].y, points[j].z );
+					const V3fVectorData *p2 = samples[i].second ? samples[i].second->variableData<V3fVectorData>( "P", PrimitiveVariable::Vertex ) : nullptr;
+					writePositions( p->readable(), p2 ? &p2->readable() : nullptr, mP );
+					mP += p->readable().size();
 				}
 				else
 				{
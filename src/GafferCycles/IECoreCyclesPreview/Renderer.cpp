@@ -53,7 +53,9 @@
 
 #include "IECoreScene/Camera.h"
 #include "IECoreScene/CurvesPrimitive.h"
+#include "IECoreScene/ExternalProcedural.h"
 #include "IECoreScene/MeshPrimitive.h"
+#include "IECoreScene/PointsPrimitive.h"
 #include "IECoreScene/Shader.h"
 #include "IECoreScene/SpherePrimitive.h"
 #include "IECoreScene/Transform.h"
@@ -69,17 +71,40 @@
 #include "IECore/StringAlgo.h"
 #include "IECore/VectorTypedData.h"
 
+#include "OpenEXR/ImathBoxAlgo.h"
 #include "OpenEXR/ImathMatrixAlgo.h"
 
 #include "boost/algorithm/string.hpp"
 #include "boost/algorithm/string/predicate.hpp"
 #include "boost/optional.hpp"
 
+#ifdef WITH_ALEMBIC
+#include "Alembic/AbcCoreFactory/IFactory.h"
+#include "Alembic/AbcGeom/ICurves.h"
+#include "Alembic/AbcGeom/IPoints.h"
+#include "Alembic/AbcGeom/IPolyMesh.h"
+#include "Alembic/AbcGeom/ISubD.h"
+#endif
+
 #include "tbb/concurrent_unordered_map.h"
+#include "tbb/concurrent_unordered_set.h"
 #include "tbb/concurrent_hash_map.h"
 #include "tbb/concurrent_vector.h"
-
+#include "tbb/enumerable_thread_specific.h"
+#include "tbb/parallel_for.h"
+#include "tbb/parallel_reduce.h"
+#include "tbb/task_arena.h"
+#include "tbb/task_group.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <limits>
+#include <map>
+#include <set>
 #include <unordered_map>
+#include <unordered_set>
 
 // Cycles
 #include "bvh/params.h"
@@ -88,6 +113,9 @@
 #include "graph/node_type.h"
 #include "kernel/types.h"
 #include "scene/background.h"
+#ifdef WITH_ALEMBIC
+#include "scene/alembic.h"
+#endif
 #include "session/buffers.h"
 #include "scene/curves.h"
 #include "scene/film.h"
@@ -136,7 +164,6 @@ typedef std::shared_ptr<ccl::Camera> SharedCCameraPtr;
 typedef std::shared_ptr<ccl::Object> SharedCObjectPtr;
 typedef std::shared_ptr<ccl::Light> SharedCLightPtr;
 typedef std::shared_ptr<ccl::Geometry> SharedCGeometryPtr;
-typedef std::shared_ptr<ccl::ParticleSystem> SharedCParticleSystemPtr;
 // Need to defer shader assignments to the scene lock
 typedef std::pair<ccl::Node*, ccl::array<ccl::Node*>> ShaderAssignPair;
 // Defer adding the created nodes to the scene lock
@@ -149,27 +176,6 @@ bool nullNodeDeleter( ccl::Node *node )
 	return false;
 }
 
-// Helper to swap the node to delete to the front of the vector, then pop off
-template<typename T, typename U>
-static void removeNodesInSet( const ccl::set<T *> &nodesSet, tbb::concurrent_vector<U> &nodesArray )
-{
-	size_t newSize = nodesArray.size();
-
-	for (size_t i = 0; i < newSize; ++i)
-	{
-		U node = nodesArray[i];
-
-		if( nodesSet.find( node.get() ) != nodesSet.end() )
-		{
-			std::swap(nodesArray[i], nodesArray[newSize - 1]);
-			i -= 1;
-			newSize -= 1;
-		}
-	}
-
-	nodesArray.resize(newSize);
-}
-
 template<typename T>
 T *reportedCast( const IECore::RunTimeTyped *v, const char *type, const IECore::InternedString &name )
 {
@@ -425,7 +431,9 @@ class CyclesShader : public IECore::RefCounted
 		// Default shader
 		CyclesShader( ccl::Scene *scene )
 			:	m_shader( ShaderNetworkAlgo::createDefaultShader() ),
-				m_hash( IECore::MurmurHash() )
+				m_hash( IECore::MurmurHash() ),
+				m_topologyHash( IECore::MurmurHash() ),
+				m_sharingHash( IECore::MurmurHash() )
 		{
 			m_shader->set_owner( scene );
 		}
@@ -436,10 +444,12 @@ class CyclesShader : public IECore::RefCounted
 					  ccl::Scene *scene,
 					  const std::string &name, 
 					  const IECore::MurmurHash &h,
+					  const IECore::MurmurHash &topologyHash,
+					  const IECore::MurmurHash &sharingHash,
 					  const bool singleSided, 
 					  const IECore::InternedString displacementMethod,
 					  vector<const IECoreScene::ShaderNetwork *> &aovShaders )
-			:	m_hash( h )
+			:	m_hash( h ), m_topologyHash( topologyHash ), m_sharingHash( sharingHash )
 		{
 			ccl::ShaderGraph *graph = ShaderNetworkAlgo::convertGraph( surfaceShader, displacementShader, volumeShader, scene->shader_manager, name );
 			if( surfaceShader && singleSided )
@@ -479,11 +489,49 @@ class CyclesShader : public IECore::RefCounted
 			h.append( m_hash );
 		}
 
+		const IECore::MurmurHash &shaderHash() const
+		{
+			return m_hash;
+		}
+
 		ccl::Shader *shader() const
 		{
 			return m_shader;
 		}
 
+		const IECore::MurmurHash &topologyHash() const
+		{
+			return m_topologyHash;
+		}
+
+		// Hash of everything except the parameter values of the networks
+		// themselves, including substitutions from attributes. Shaders that
+		// only differ by an edit to network parameters have the same sharing
+		// hash, and the edit is applied to the existing `ccl::Shader` in place.
+		const IECore::MurmurHash &sharingHash() const
+		{
+			return m_sharingHash;
+		}
+
+		// Moves our graph onto the `ccl::Shader` owned by `previous`, and adopts
+		// that shader in place of our own. Used when only parameter values have
+		// changed, so that geometry and lights don't need reassigning.
+		void adopt( CyclesShader *previous, ccl::Scene *scene )
+		{
+			ccl::Shader *shader = previous->m_shader;
+			ccl::ShaderGraph *graph = m_shader->graph;
+			m_shader->graph = nullptr;
+
+			shader->name = m_shader->name;
+			shader->set_graph( graph );
+			shader->tag_update( scene );
+
+			// Never added to the scene, so we can delete it ourselves.
+			delete m_shader;
+			m_shader = shader;
+			previous->m_shader = nullptr;
+		}
+
 		void nodesCreated( NodesCreated &nodes )
 		{
 			// Only get the first instance
@@ -497,6 +545,8 @@ class CyclesShader : public IECore::RefCounted
 
 		ccl::Shader *m_shader;
 		const IECore::MurmurHash m_hash;
+		const IECore::MurmurHash m_topologyHash;
+		const IECore::MurmurHash m_sharingHash;
 
 };
 
@@ -512,10 +562,11 @@ class ShaderCache : public IECore::RefCounted
 	public :
 
 		ShaderCache( ccl::Scene *scene )
-			: m_scene( scene )
+			: m_scene( scene ), m_numOSLShaders( 0 )
 		{
 			m_numDefaultShaders = m_scene->shaders.size();
 			m_defaultSurface = new CyclesShader( m_scene );
+			m_shadersCreated.push_back( m_defaultSurface );
 		}
 
 		~ShaderCache()
@@ -550,10 +601,15 @@ class ShaderCache : public IECore::RefCounted
 			vector<const IECoreScene::ShaderNetwork*> aovShaders;
 			bool prototype = false;
 
+			// Hash of everything except parameter values, used to find shaders
+			// that can be updated in place rather than replaced.
+			IECore::MurmurHash topologyHash = h;
+
 			// Surface hash
 			if( surfaceShader )
 			{
 				h.append( surfaceShader->Object::hash() );
+				hashTopology( surfaceShader, topologyHash );
 				if( attributes )
 				{
 					surfaceShader->hashSubstitutions( attributes, hSubst );
@@ -567,6 +623,7 @@ class ShaderCache : public IECore::RefCounted
 						if( !doubleSided )
 						{
 							h.append( "singleSided" );
+							topologyHash.append( "singleSided" );
 							singleSided = true;
 						}
 					}
@@ -577,6 +634,8 @@ class ShaderCache : public IECore::RefCounted
 			if( displacementShader )
 			{
 				IECore::MurmurHash disph = displacementShader->Object::hash();
+				topologyHash.append( "displacement" );
+				hashTopology( displacementShader, topologyHash );
 				if( attributes )
 				{
 					displacementShader->hashSubstitutions( attributes, hSubstDisp );
@@ -595,12 +654,15 @@ class ShaderCache : public IECore::RefCounted
 					}
 				}
 				h.append( disph );
+				topologyHash.append( displacementMethod );
 			}
 
 			// Volume hash
 			if( volumeShader )
 			{
 				IECore::MurmurHash volh = volumeShader->Object::hash();
+				topologyHash.append( "volume" );
+				hashTopology( volumeShader, topologyHash );
 				if( attributes )
 				{
 					volumeShader->hashSubstitutions( attributes, hSubstVol );
@@ -624,6 +686,8 @@ class ShaderCache : public IECore::RefCounted
 							aovShader->hashSubstitutions( attributes, hSubstAov );
 							aovh.append( hSubstAov );
 							h.append( aovh );
+							topologyHash.append( member.first );
+							hashTopology( aovShader, topologyHash );
 							hSubstAovs.push_back( hSubstAov );
 							aovShaders.push_back( aovShader );
 						}
@@ -631,6 +695,15 @@ class ShaderCache : public IECore::RefCounted
 				}
 			}
 
+			IECore::MurmurHash sharingHash = topologyHash;
+			sharingHash.append( hSubst );
+			sharingHash.append( hSubstDisp );
+			sharingHash.append( hSubstVol );
+			for( const IECore::MurmurHash &hSubstAov : hSubstAovs )
+			{
+				sharingHash.append( hSubstAov );
+			}
+
 			Cache::const_accessor readAccessor;
 			if( m_cache.find( readAccessor, h ) )
 			{
@@ -680,7 +753,8 @@ class ShaderCache : public IECore::RefCounted
 						}
 					}
 
-					writeAccessor->second = new CyclesShader( surfaceShader, displacementShader, volumeShader, m_scene, namePrefix, h, singleSided, displacementMethod, aovShaders );
+					writeAccessor->second = new CyclesShader( surfaceShader, displacementShader, volumeShader, m_scene, namePrefix, h, topologyHash, sharingHash, singleSided, displacementMethod, aovShaders );
+					m_shadersCreated.push_back( writeAccessor->second );
 				}
 			}
 
@@ -695,10 +769,127 @@ class ShaderCache : public IECore::RefCounted
 		// Must not be called concurrently with anything.
 		void clearUnused()
 		{
-			// TODO: Cycles currently doesn't delete unused shaders anyways and it's problematic
-			// to delete them in a live render, so we just retain all shaders created, Cycles
-			// will delete them all once the session is finished.
-			return;
+			updateInPlace();
+
+			// Shaders only referenced by the cache itself are no longer
+			// used by any attributes.
+			vector<IECore::MurmurHash> candidates;
+			for( Cache::const_iterator it = m_cache.begin(), eIt = m_cache.end(); it != eIt; ++it )
+			{
+				if( it->second && it->second->refCount() == 1 )
+				{
+					candidates.push_back( it->first );
+				}
+			}
+
+			if( candidates.empty() )
+			{
+				return;
+			}
+
+			// Cycles nodes may still point at a shader whose attributes have
+			// gone, for instance geometry shared with another instance or an
+			// assignment that hasn't been applied yet. Those must survive
+			// until the next update.
+			std::unordered_set<const ccl::Node *> inUse;
+			for( const ccl::Geometry *geo : m_scene->geometry )
+			{
+				for( const ccl::Node *node : geo->get_used_shaders() )
+				{
+					inUse.insert( node );
+				}
+			}
+			for( const ccl::Light *light : m_scene->lights )
+			{
+				inUse.insert( light->get_shader() );
+			}
+			for( const ShaderAssignPair &shaderAssignPair : m_shaderAssignPairs )
+			{
+				for( const ccl::Node *node : shaderAssignPair.second )
+				{
+					inUse.insert( node );
+				}
+			}
+			inUse.insert( m_scene->background->get_shader( m_scene ) );
+
+			std::unordered_set<ccl::Shader *> freed;
+			int firstFreedId = std::numeric_limits<int>::max();
+			for( const IECore::MurmurHash &h : candidates )
+			{
+				Cache::accessor a;
+				if( !m_cache.find( a, h ) )
+				{
+					continue;
+				}
+				ccl::Shader *shader = a->second->shader();
+				if( inUse.count( shader ) )
+				{
+					continue;
+				}
+				freed.insert( shader );
+				if( shader->id >= 0 )
+				{
+					firstFreedId = std::min( firstFreedId, shader->id );
+				}
+				m_cache.erase( a );
+			}
+
+			if( freed.empty() )
+			{
+				return;
+			}
+
+			// Compact the scene shaders, preserving the order of the rest.
+			ccl::vector<ccl::Shader *> &shaders = m_scene->shaders;
+			shaders.erase(
+				std::remove_if( shaders.begin(), shaders.end(), [&freed]( ccl::Shader *shader ) { return freed.count( shader ); } ),
+				shaders.end()
+			);
+
+			// Shader ids are indices into `scene->shaders`, so geometry,
+			// lights and the background using any shader after the first
+			// freed one need their packed shader ids updating.
+			for( ccl::Geometry *geo : m_scene->geometry )
+			{
+				// Read through a const pointer, so that geometry we don't
+				// tag isn't marked as having modified shaders.
+				for( const ccl::Node *node : static_cast<const ccl::Geometry *>( geo )->get_used_shaders() )
+				{
+					if( static_cast<const ccl::Shader *>( node )->id > firstFreedId )
+					{
+						geo->tag_update( m_scene, false );
+						break;
+					}
+				}
+			}
+			for( ccl::Light *light : m_scene->lights )
+			{
+				if( light->get_shader() && light->get_shader()->id > firstFreedId )
+				{
+					light->tag_update( m_scene );
+				}
+			}
+			const ccl::Shader *backgroundShader = m_scene->background->get_shader( m_scene );
+			if( backgroundShader && backgroundShader->id > firstFreedId )
+			{
+				m_scene->background->tag_update( m_scene );
+			}
+
+			// Cycles doesn't support deleting shaders through
+			// `Scene::delete_nodes()`, so we do it ourselves.
+			for( ccl::Shader *shader : freed )
+			{
+				if( IECoreCycles::ShaderNetworkAlgo::hasOSL( shader ) )
+				{
+					--m_numOSLShaders;
+				}
+				delete shader;
+			}
+
+			// Removal invalidates the shader table in the same way as an addition.
+			m_scene->shader_manager->tag_update( m_scene, ccl::ShaderManager::SHADER_ADDED );
+
+			IECore::msg( IECore::Msg::Debug, "CyclesRenderer", boost::format( "Freed %d unused shaders, %d remaining." ) % freed.size() % m_cache.size() );
 		}
 
 		// Must not be called concurrently with anything.
@@ -707,7 +898,7 @@ class ShaderCache : public IECore::RefCounted
 			nodes.push_back( m_defaultSurface->shader() );
 			for( Cache::const_iterator it = m_cache.begin(), eIt = m_cache.end(); it != eIt; ++it )
 			{
-				if( it->second->shader() )
+				if( it->second && it->second->shader() )
 				{
 					nodes.push_back( it->second->shader() );
 				}
@@ -721,12 +912,7 @@ class ShaderCache : public IECore::RefCounted
 
 		bool hasOSLShader()
 		{
-			for( ccl::Shader *shader : m_scene->shaders )
-			{
-				if( IECoreCycles::ShaderNetworkAlgo::hasOSL( shader ) )
-					return true;
-			}
-			return false;
+			return m_numOSLShaders > 0;
 		}
 
 		uint32_t numDefaultShaders()
@@ -775,49 +961,227 @@ class ShaderCache : public IECore::RefCounted
 
 	private :
 
+		static void hashTopology( const IECoreScene::ShaderNetwork *network, IECore::MurmurHash &h )
+		{
+			for( const auto &namedShader : network->shaders() )
+			{
+				h.append( namedShader.first );
+				h.append( namedShader.second->getName() );
+				h.append( namedShader.second->getType() );
+				for( const auto &connection : network->inputConnections( namedShader.first ) )
+				{
+					h.append( connection.source.shader );
+					h.append( connection.source.name );
+					h.append( connection.destination.name );
+				}
+			}
+			h.append( network->getOutput().shader );
+			h.append( network->getOutput().name );
+		}
+
+		// Shaders created since the last update which differ from a now
+		// unused shader only by parameter values take over that shader
+		// rather than being added to the scene.
+		void updateInPlace()
+		{
+			std::unordered_map<const ccl::Node *, ccl::Node *> replaced;
+			for( const CyclesShaderPtr &created : m_shadersCreated )
+			{
+				auto range = m_topologies.equal_range( created->topologyHash() );
+				for( auto it = range.first; it != range.second; )
+				{
+					Cache::accessor a;
+					if( !m_cache.find( a, it->second ) )
+					{
+						// Freed by `clearUnused()`.
+						it = m_topologies.erase( it );
+						continue;
+					}
+
+					CyclesShader *previous = a->second.get();
+					if( previous == created.get() || previous->refCount() > 1 )
+					{
+						++it;
+						continue;
+					}
+
+					ccl::Node *fresh = created->shader();
+					created->adopt( previous, m_scene );
+					replaced[fresh] = created->shader();
+					m_shadersAdopted.insert( created.get() );
+					m_cache.erase( a );
+					m_topologies.erase( it );
+					break;
+				}
+			}
+
+			if( replaced.empty() )
+			{
+				return;
+			}
+
+			for( ShaderAssignPair &shaderAssignPair : m_shaderAssignPairs )
+			{
+				for( ccl::Node *&node : shaderAssignPair.second )
+				{
+					auto it = replaced.find( node );
+					if( it != replaced.end() )
+					{
+						node = it->second;
+					}
+				}
+			}
+
+			IECore::msg( IECore::Msg::Debug, "CyclesRenderer", boost::format( "Updated %d shaders in place." ) % replaced.size() );
+		}
+
 		void updateShaders( NodesCreated &nodes )
 		{
-			// We need to update all of these, it seems as though being fine-grained causes
-			// graphical glitches unfortunately.
-			if( m_shaderAssignPairs.size() )
+			// Register shaders with the scene. For a new scene `nodes` holds
+			// every shader, otherwise we only append those created since the
+			// last update, so an update without shader changes does no work.
+			ccl::vector<ccl::Shader *> &shaders = m_scene->shaders;
+			bool added = false;
+			if( nodes.size() )
+			{
+				shaders.resize( m_numDefaultShaders );
+				m_numOSLShaders = 0;
+				for( ccl::Node *node : nodes )
+				{
+					registerShader( static_cast<ccl::Shader *>( node ) );
+				}
+				added = true;
+			}
+			else
+			{
+				for( const CyclesShaderPtr &created : m_shadersCreated )
+				{
+					// Adopted shaders are already in the scene.
+					if( !m_shadersAdopted.count( created.get() ) )
+					{
+						registerShader( created->shader() );
+						added = true;
+					}
+				}
+			}
+
+			// Shaders given a new graph in this update. Adopted shaders keep
+			// their `ccl::Shader`, so this is the only record of the change.
+			std::unordered_set<const ccl::Shader *> newGraphs;
+			for( const CyclesShaderPtr &created : m_shadersCreated )
+			{
+				m_topologies.insert( std::make_pair( created->topologyHash(), created->shaderHash() ) );
+				newGraphs.insert( created->shader() );
+			}
+			m_shadersCreated.clear();
+			m_shadersAdopted.clear();
+			nodes.clear();
+
+			if( added )
 			{
-				m_scene->light_manager->tag_update( m_scene, ccl::LightManager::UPDATE_ALL );
-				m_scene->geometry_manager->tag_update( m_scene, ccl::GeometryManager::UPDATE_ALL );
+				m_scene->shader_manager->tag_update( m_scene, ccl::ShaderManager::SHADER_ADDED );
+				m_scene->background->tag_update( m_scene );
 			}
-			// Do the shader assignment here
-			for( ShaderAssignPair shaderAssignPair : m_shaderAssignPairs )
+
+			// Do the shader assignment here. Only geometry and lights whose
+			// assignment actually changed are tagged, so that an edit to one
+			// object doesn't force every mesh and light to be re-uploaded.
+			//
+			// This used to tag everything with `UPDATE_ALL`, because setting
+			// `used_shaders` alone left glitches behind. The socket change only
+			// marks the geometry itself as modified, so Cycles would keep :
+			//
+			// - The emissive triangles of the old shaders in the light
+			//   distribution, until something else rebuilt it.
+			// - Displaced vertices from the old displacement shader, because
+			//   displacement is only re-applied when the mesh is rebuilt.
+			// - Object flags derived from the old shaders, such as those
+			//   for volumes and transparent shadows.
+			//
+			// Each of these is now tagged explicitly below : the light manager
+			// when the old shaders were emissive (the new ones are handled by
+			// `Geometry::tag_update()`), a rebuild when either side has true
+			// displacement, and the object manager once for all geometry.
+#ifndef NDEBUG
+			const GeometryShaders previousShaders = geometryShaders();
+#endif
+			bool geometryChanged = false;
+			for( const ShaderAssignPair &shaderAssignPair : m_shaderAssignPairs )
 			{
 				if( shaderAssignPair.first->is_a( ccl::Geometry::get_node_base_type() ) )
 				{
+					ccl::Geometry *geo = static_cast<ccl::Geometry*>( shaderAssignPair.first );
+					// Read through a const pointer, so the socket isn't
+					// tagged as modified when the assignment is unchanged.
+					if( static_cast<const ccl::Geometry *>( geo )->get_used_shaders() == shaderAssignPair.second )
+					{
+						continue;
+					}
+
+					// Emission and true displacement on either side of the
+					// change need more than a plain geometry update. Emissive
+					// shaders on the new side are handled by `Geometry::tag_update()`.
+					bool rebuild = false;
+					bool emissive = false;
+					for( ccl::Node *node : static_cast<const ccl::Geometry *>( geo )->get_used_shaders() )
+					{
+						const ccl::Shader *shader = static_cast<const ccl::Shader *>( node );
+						rebuild |= hasTrueDisplacement( shader );
+						emissive |= shader->has_surface_emission;
+					}
 					for( ccl::Node *node : shaderAssignPair.second )
 					{
 						ccl::Shader *shader = static_cast<ccl::Shader *>( node );
 						shader->tag_used( m_scene );
+						rebuild |= hasTrueDisplacement( shader );
 					}
-					ccl::Geometry *geo = static_cast<ccl::Geometry*>( shaderAssignPair.first );
+
 					geo->set_used_shaders( shaderAssignPair.second );
+					geo->tag_update( m_scene, rebuild );
+					if( emissive )
+					{
+						m_scene->light_manager->tag_update( m_scene, ccl::LightManager::EMISSIVE_MESH_MODIFIED );
+					}
+					geometryChanged = true;
 				}
 				else if( shaderAssignPair.first->is_a( ccl::Light::get_node_type() ) )
 				{
 					ccl::Light *light = static_cast<ccl::Light*>( shaderAssignPair.first );
+					ccl::Shader *shader = m_scene->default_light;
 					if( shaderAssignPair.second[0] )
 					{
-						ccl::Shader *shader = static_cast<ccl::Shader *>( shaderAssignPair.second[0] );
+						shader = static_cast<ccl::Shader *>( shaderAssignPair.second[0] );
 						shader->tag_used( m_scene );
-						light->set_shader( shader );
 					}
-					else
+
+					if( light->get_shader() != shader )
 					{
-						light->set_shader( m_scene->default_light );
+						light->set_shader( shader );
+						light->tag_update( m_scene );
 					}
 				}
 			}
+
+			if( geometryChanged )
+			{
+				// Object flags (volume, transparency etc) are derived from the
+				// shaders used by the geometry.
+				m_scene->object_manager->tag_update( m_scene, ccl::ObjectManager::OBJECT_MODIFIED );
+			}
+#ifndef NDEBUG
+			checkShaderAssignments( previousShaders );
+#endif
 			m_shaderAssignPairs.clear();
 
-			// TODO: Optimise
 			for( ccl::Light *light : m_scene->lights )
 			{
-				if( light->get_light_type() == ccl::LIGHT_BACKGROUND )
+				// Only recompile the environment shader when the light has
+				// actually been moved, given a new shader, or had its shader's
+				// graph replaced by an in-place update, which resets the rotation.
+				if(
+					light->get_light_type() == ccl::LIGHT_BACKGROUND &&
+					( light->tfm_is_modified() || light->shader_is_modified() || newGraphs.count( light->get_shader() ) )
+				)
 				{
 					// Set environment map rotation
 					Imath::M44f transform =  SocketAlgo::getTransform( light->get_tfm() );
@@ -835,21 +1199,73 @@ class ShaderCache : public IECore::RefCounted
 					}
 				}
 			}
+		}
+
+		void registerShader( ccl::Shader *shader )
+		{
+			m_scene->shaders.push_back( shader );
+			if( IECoreCycles::ShaderNetworkAlgo::hasOSL( shader ) )
+			{
+				++m_numOSLShaders;
+			}
+		}
 
-			ccl::vector<ccl::Shader *> &shaders = m_scene->shaders;
-			if( nodes.size() + m_numDefaultShaders > shaders.size() )
+#ifndef NDEBUG
+
+		typedef std::unordered_map<const ccl::Geometry *, ccl::array<ccl::Node *>> GeometryShaders;
+
+		GeometryShaders geometryShaders() const
+		{
+			GeometryShaders result;
+			for( const ccl::Geometry *geo : m_scene->geometry )
 			{
-				shaders.resize( m_numDefaultShaders );
-				for( ccl::Node *node : nodes )
+				result[geo] = geo->get_used_shaders();
+			}
+			return result;
+		}
+
+		// Checks that `updateShaders()` gave each queued geometry its new
+		// shaders and tagged it for update, and left all other geometry
+		// untouched. This guards against the glitches that once made us tag
+		// everything with `UPDATE_ALL`, where reassigning the shader of one
+		// of several geometries affected the others.
+		void checkShaderAssignments( const GeometryShaders &previousShaders ) const
+		{
+			GeometryShaders expected = previousShaders;
+			for( const ShaderAssignPair &shaderAssignPair : m_shaderAssignPairs )
+			{
+				if( shaderAssignPair.first->is_a( ccl::Geometry::get_node_base_type() ) )
 				{
-					ccl::Shader *shader = static_cast<ccl::Shader *>( node );
-					shaders.push_back( shader );
+					expected[static_cast<const ccl::Geometry *>( shaderAssignPair.first )] = shaderAssignPair.second;
 				}
-				m_scene->shader_manager->tag_update( m_scene, ccl::ShaderManager::SHADER_ADDED );
-				// TODO: Optimise
-				m_scene->background->tag_update( m_scene );
 			}
-			nodes.clear();
+
+			for( const ccl::Geometry *geo : m_scene->geometry )
+			{
+				auto it = expected.find( geo );
+				if( it == expected.end() )
+				{
+					continue;
+				}
+				assert( geo->get_used_shaders() == it->second );
+
+				auto previous = previousShaders.find( geo );
+				if( previous != previousShaders.end() && !( previous->second == it->second ) )
+				{
+					assert( geo->is_modified() );
+				}
+			}
+		}
+
+#endif // NDEBUG
+
+		static bool hasTrueDisplacement( const ccl::Shader *shader )
+		{
+			if( shader->get_displacement_method() == ccl::DISPLACE_BUMP || !shader->graph )
+			{
+				return false;
+			}
+			return shader->graph->output()->input( "Displacement" )->link;
 		}
 
 		ccl::Scene *m_scene;
@@ -860,6 +1276,13 @@ class ShaderCache : public IECore::RefCounted
 		// Need to assign shaders in a deferred manner
 		typedef tbb::concurrent_vector<ShaderAssignPair> ShaderAssignVector;
 		ShaderAssignVector m_shaderAssignPairs;
+		// Shaders created since the last update, and the hashes of all
+		// shaders keyed by topology. Used by `updateInPlace()`.
+		tbb::concurrent_vector<CyclesShaderPtr> m_shadersCreated;
+		std::unordered_set<const CyclesShader *> m_shadersAdopted;
+		// Number of registered shaders using OSL nodes.
+		int m_numOSLShaders;
+		std::multimap<IECore::MurmurHash, IECore::MurmurHash> m_topologies;
 
 };
 
@@ -868,53 +1291,273 @@ IE_CORE_DECLAREPTR( ShaderCache )
 } // namespace
 
 //////////////////////////////////////////////////////////////////////////
-// CyclesAttributes
+// ParticleSystemCache
 //////////////////////////////////////////////////////////////////////////
 
 namespace
 {
 
-// Standard Attributes
-IECore::InternedString g_visibilityAttributeName( "visibility" );
-IECore::InternedString g_transformBlurAttributeName( "transformBlur" );
-IECore::InternedString g_transformBlurSegmentsAttributeName( "transformBlurSegments" );
-IECore::InternedString g_deformationBlurAttributeName( "deformationBlur" );
-IECore::InternedString g_deformationBlurSegmentsAttributeName( "deformationBlurSegments" );
-// Cycles Attributes
-IECore::InternedString g_cclVisibilityAttributeName( "ccl:visibility" );
-IECore::InternedString g_useHoldoutAttributeName( "ccl:use_holdout" );
-IECore::InternedString g_isShadowCatcherAttributeName( "ccl:is_shadow_catcher" );
-IECore::InternedString g_shadowTerminatorShadingOffsetAttributeName( "ccl:shadow_terminator_shading_offset" );
-IECore::InternedString g_shadowTerminatorGeometryOffsetAttributeName( "ccl:shadow_terminator_geometry_offset" );
-IECore::InternedString g_maxLevelAttributeName( "ccl:max_level" );
-IECore::InternedString g_dicingRateAttributeName( "ccl:dicing_rate" );
-// Per-object color
-IECore::InternedString g_colorAttributeName( "Cs" );
-// Cycles Light
-IECore::InternedString g_lightAttributeName( "ccl:light" );
-// Dupli
-IECore::InternedString g_dupliGeneratedAttributeName( "ccl:dupli_generated" );
-IECore::InternedString g_dupliUVAttributeName( "ccl:dupli_uv" );
-// Particle
-std::array<IECore::InternedString, 2> g_particleIndexAttributeNames = { {
-	"index",
-	"instanceIndex",
-} };
-IECore::InternedString g_particleAgeAttributeName( "age" );
-IECore::InternedString g_particleLifetimeAttributeName( "lifetime" );
-std::array<IECore::InternedString, 2> g_particleLocationAttributeNames = { {
-	"location",
-	"P",
-} };
-IECore::InternedString g_particleRotationAttributeName( "rotation" );
-std::array<IECore::InternedString, 2> g_particleRotationAttributeNames = { {
-	"rotation",
-	"orientation",
-} };
-std::array<IECore::InternedString, 2> g_particleSizeAttributeNames = { {
-	"size",
-	"width",
-} };
+// Holds a single particle system shared by all objects with particle info.
+// Particle info is buffered per thread during translation and merged into
+// the particle system in a single pass at the scene lock.
+class ParticleSystemsCache : public IECore::RefCounted
+{
+
+	public :
+
+		ParticleSystemsCache( ccl::Scene *scene )
+			: m_scene( scene ), m_particleSystem( new ccl::ParticleSystem() ), m_registered( false ), m_sequence( 0 )
+		{
+		}
+
+		~ParticleSystemsCache() override
+		{
+			if( !m_registered )
+			{
+				delete m_particleSystem;
+			}
+		}
+
+		void update( ccl::Scene *scene, NodesCreated &psys )
+		{
+			m_scene = scene;
+			mergeParticles();
+			if( !m_registered && m_owners.size() )
+			{
+				psys.push_back( m_particleSystem );
+				m_registered = true;
+			}
+			updateParticleSystems( psys );
+		}
+
+		ccl::ParticleSystem *particleSystem() const
+		{
+			return m_particleSystem;
+		}
+
+		// Queues the particle info for `object`, to be merged into the
+		// particle system by `update()`. Can be called concurrently with
+		// anything except `update()` and `clearUnused()`.
+		void setParticle( ccl::Object *object, const ccl::Particle &particle )
+		{
+			m_pending.local().push_back( PendingParticle{ object, particle, m_sequence++ } );
+		}
+
+		// Called when an object using the particle system is released.
+		// Can be called concurrently with anything except `clearUnused()`.
+		void retire( ccl::Object *object )
+		{
+			m_retired.push_back( object );
+		}
+
+		// Only visits objects retired since the last call. Particles of
+		// released objects are filled from the end of the array, so the
+		// particle system stays compact.
+		// Must not be called concurrently with anything.
+		void clearUnused()
+		{
+			if( m_retired.empty() )
+			{
+				return;
+			}
+
+			const std::unordered_set<ccl::Object *> retired( m_retired.begin(), m_retired.end() );
+			m_retired.clear();
+
+			for( auto &pending : m_pending )
+			{
+				pending.erase(
+					std::remove_if( pending.begin(), pending.end(), [&retired]( const PendingParticle &p ) { return retired.count( p.object ); } ),
+					pending.end()
+				);
+			}
+
+			ccl::array<ccl::Particle> &particles = m_particleSystem->particles;
+			size_t size = m_owners.size();
+			for( size_t i = 0; i < size; )
+			{
+				if( !retired.count( m_owners[i] ) )
+				{
+					++i;
+					continue;
+				}
+
+				// Don't advance, as the particle we move here
+				// may belong to a released object too.
+				--size;
+				if( i != size )
+				{
+					m_owners[i] = m_owners[size];
+					particles[i] = particles[size];
+					m_owners[i]->set_particle_index( i );
+					m_owners[i]->tag_update( m_scene );
+				}
+			}
+
+			if( size != m_owners.size() )
+			{
+				IECore::msg( IECore::Msg::Debug, "CyclesRenderer", boost::format( "Reclaimed %d particles." ) % ( m_owners.size() - size ) );
+				m_owners.resize( size );
+				particles.resize( size );
+				m_particleSystem->tag_update( m_scene );
+			}
+		}
+
+		void nodesCreated( NodesCreated &nodes )
+		{
+			if( m_registered || m_owners.size() )
+			{
+				nodes.push_back( m_particleSystem );
+				m_registered = true;
+			}
+		}
+
+	private :
+
+		bool hasParticle( const ccl::Object *object ) const
+		{
+			const size_t index = object->get_particle_index();
+			return index < m_owners.size() && m_owners[index] == object;
+		}
+
+		void mergeParticles()
+		{
+			std::vector<PendingParticle> pending;
+			for( auto &p : m_pending )
+			{
+				pending.insert( pending.end(), p.begin(), p.end() );
+				p.clear();
+			}
+
+			if( pending.empty() )
+			{
+				return;
+			}
+
+			// Objects may have been updated more than once, on
+			// different threads, so apply in the order of arrival.
+			std::sort(
+				pending.begin(), pending.end(),
+				[]( const PendingParticle &a, const PendingParticle &b ) { return a.sequence < b.sequence; }
+			);
+
+			// Allocate space for new objects up front, so the
+			// particle array is only resized once.
+			m_owners.reserve( m_owners.size() + pending.size() );
+			for( const PendingParticle &p : pending )
+			{
+				if( !hasParticle( p.object ) )
+				{
+					p.object->set_particle_index( m_owners.size() );
+					p.object->tag_update( m_scene );
+					m_owners.push_back( p.object );
+				}
+			}
+			m_particleSystem->particles.resize( m_owners.size() );
+
+			ccl::Particle *particles = m_particleSystem->particles.data();
+			for( const PendingParticle &p : pending )
+			{
+				particles[p.object->get_particle_index()] = p.particle;
+			}
+
+			m_particleSystem->tag_update( m_scene );
+		}
+
+		void updateParticleSystems( NodesCreated &nodes )
+		{
+			if( nodes.size() )
+			{
+				ccl::vector<ccl::ParticleSystem *> &particleSystems = m_scene->particle_systems;
+				for( ccl::Node *node : nodes )
+				{
+					particleSystems.push_back( static_cast<ccl::ParticleSystem *>( node ) );
+				}
+				m_scene->particle_system_manager->tag_update( m_scene );
+				nodes.clear();
+			}
+		}
+
+		struct PendingParticle
+		{
+			ccl::Object *object;
+			ccl::Particle particle;
+			size_t sequence;
+		};
+
+		ccl::Scene *m_scene;
+		ccl::ParticleSystem *m_particleSystem;
+		bool m_registered;
+		// The object using each particle, indexed the same
+		// as the particles themselves.
+		std::vector<ccl::Object *> m_owners;
+		std::atomic<size_t> m_sequence;
+		tbb::enumerable_thread_specific<std::vector<PendingParticle>> m_pending;
+		tbb::concurrent_vector<ccl::Object *> m_retired;
+
+};
+
+IE_CORE_DECLAREPTR( ParticleSystemsCache )
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// CyclesAttributes
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// Standard Attributes
+IECore::InternedString g_visibilityAttributeName( "visibility" );
+IECore::InternedString g_transformBlurAttributeName( "transformBlur" );
+IECore::InternedString g_transformBlurSegmentsAttributeName( "transformBlurSegments" );
+IECore::InternedString g_deformationBlurAttributeName( "deformationBlur" );
+IECore::InternedString g_deformationBlurSegmentsAttributeName( "deformationBlurSegments" );
+// Cycles Attributes
+IECore::InternedString g_cclVisibilityAttributeName( "ccl:visibility" );
+IECore::InternedString g_useHoldoutAttributeName( "ccl:use_holdout" );
+IECore::InternedString g_isShadowCatcherAttributeName( "ccl:is_shadow_catcher" );
+IECore::InternedString g_shadowTerminatorShadingOffsetAttributeName( "ccl:shadow_terminator_shading_offset" );
+IECore::InternedString g_shadowTerminatorGeometryOffsetAttributeName( "ccl:shadow_terminator_geometry_offset" );
+IECore::InternedString g_autoNormalsAttributeName( "ccl:auto_normals" );
+IECore::InternedString g_colorPrecisionAttributeName( "ccl:color_precision" );
+IECore::InternedString g_curveDensityAttributeName( "ccl:curve_density" );
+IECore::InternedString g_curvesPerPixelAttributeName( "ccl:curves_per_pixel" );
+IECore::InternedString g_velocityBlurAttributeName( "ccl:velocity_blur" );
+IECore::InternedString g_velocityScaleAttributeName( "ccl:velocity_scale" );
+IECore::InternedString g_motionToleranceAttributeName( "ccl:motion_tolerance" );
+IECore::InternedString g_motionPixelToleranceAttributeName( "ccl:motion_pixel_tolerance" );
+IECore::InternedString g_maxLevelAttributeName( "ccl:max_level" );
+IECore::InternedString g_dicingRateAttributeName( "ccl:dicing_rate" );
+IECore::InternedString g_subdivisionInstancingAttributeName( "ccl:subdivision_instancing" );
+// Per-object color
+IECore::InternedString g_colorAttributeName( "Cs" );
+// Cycles Light
+IECore::InternedString g_lightAttributeName( "ccl:light" );
+// Dupli
+IECore::InternedString g_dupliGeneratedAttributeName( "ccl:dupli_generated" );
+IECore::InternedString g_dupliUVAttributeName( "ccl:dupli_uv" );
+// Particle
+std::array<IECore::InternedString, 2> g_particleIndexAttributeNames = { {
+	"index",
+	"instanceIndex",
+} };
+IECore::InternedString g_particleAgeAttributeName( "age" );
+IECore::InternedString g_particleLifetimeAttributeName( "lifetime" );
+std::array<IECore::InternedString, 2> g_particleLocationAttributeNames = { {
+	"location",
+	"P",
+} };
+IECore::InternedString g_particleRotationAttributeName( "rotation" );
+std::array<IECore::InternedString, 2> g_particleRotationAttributeNames = { {
+	"rotation",
+	"orientation",
+} };
+std::array<IECore::InternedString, 2> g_particleSizeAttributeNames = { {
+	"size",
+	"width",
+} };
 IECore::InternedString g_particleVelocityAttributeName( "velocity" );
 IECore::InternedString g_particleAngularVelocityAttributeName( "angular_velocity" );
 
@@ -937,34 +1580,95 @@ IECore::InternedString g_cryptomatteAssetAttributeName( "ccl:asset_name" );
 // Light-group
 IECore::InternedString g_lightGroupAttributeName( "ccl:lightgroup" );
 
+// Custom attributes
+std::array<std::string, 2> g_customAttributePrefixes = { {
+	"user:",
+	"render:",
+} };
+
 // Volume
 IECore::InternedString g_volumeClippingAttributeName( "ccl:volume_clipping" );
 IECore::InternedString g_volumeStepSizeAttributeName( "ccl:volume_step_size" );
 IECore::InternedString g_volumeObjectSpaceAttributeName( "ccl:volume_object_space" );
 
+// The render camera, as needed to estimate the size of objects in the
+// image when choosing their level of detail and motion sampling.
+struct LODCamera
+{
+
+	LODCamera()
+		:	valid( false ), orthographic( false ), pixelsPerUnit( 0.0f )
+	{
+	}
+
+	// Returns the approximate size of `bound` in pixels.
+	float projectedSize( const Imath::Box3f &bound ) const
+	{
+		const float size = bound.size().length() * pixelsPerUnit;
+		if( orthographic )
+		{
+			return size;
+		}
+		return size / std::max( ( bound.center() - position ).length(), 1e-6f );
+	}
+
+	// Returns the approximate length covered by `pixels` at the nearest
+	// point of `bound`.
+	float worldSize( float pixels, const Imath::Box3f &bound ) const
+	{
+		const float size = pixels / pixelsPerUnit;
+		if( orthographic )
+		{
+			return size;
+		}
+		return size * ( Imath::closestPointInBox( position, bound ) - position ).length();
+	}
+
+	// False for panoramic cameras and when there is no render camera.
+	bool valid;
+	bool orthographic;
+	Imath::V3f position;
+	// The number of pixels covered by a unit length, at unit distance
+	// for perspective cameras.
+	float pixelsPerUnit;
+
+};
+
 class CyclesAttributes : public IECoreScenePreview::Renderer::AttributesInterface
 {
 
 	public :
 
-		CyclesAttributes( const IECore::CompoundObject *attributes, ShaderCache *shaderCache )
+		CyclesAttributes( const IECore::CompoundObject *attributes, ShaderCache *shaderCache, ParticleSystemsCache *particleSystemsCache )
 			:	m_shaderHash( IECore::MurmurHash() ), 
 				m_visibility( ~0 ), 
 				m_useHoldout( false ), 
 				m_isShadowCatcher( false ), 
 				m_shadowTerminatorShadingOffset( 0.0f ),
 				m_shadowTerminatorGeometryOffset( 0.0f ),
+				m_autoNormals( false ),
+				m_byteColors( false ),
+				m_curveDensity( 1.0f ),
+				m_curvesPerPixel( 0.0f ),
+				m_velocityBlur( false ),
+				m_velocityScale( 1.0f ),
+				m_motionTolerance( 0.0f ),
+				m_motionPixelTolerance( 0.0f ),
 				m_maxLevel( 1 ), 
 				m_dicingRate( 1.0f ), 
+				m_subdivisionInstancing( false ),
 				m_color( Color3f( 0.0f ) ), 
 				m_dupliGenerated( V3f( 0.0f ) ),
 				m_dupliUV( V2f( 0.0f) ),
 				m_particle( attributes ), 
 				m_volume( attributes ),
+				m_customAttributes( attributes ),
 				m_shaderAttributes( attributes ),
 				m_lightGroup( "" ),
 				m_assetName( "" ),
-				m_shaderCache( shaderCache )
+				m_shaderCache( shaderCache ),
+				m_particleSystemsCache( particleSystemsCache ),
+				m_numObjects( 0 )
 		{
 			updateVisibility( g_cameraVisibilityAttributeName,       (int)ccl::PATH_RAY_CAMERA,         attributes );
 			updateVisibility( g_diffuseVisibilityAttributeName,      (int)ccl::PATH_RAY_DIFFUSE,        attributes );
@@ -977,8 +1681,17 @@ class CyclesAttributes : public IECoreScenePreview::Renderer::AttributesInterfac
 			m_isShadowCatcher = attributeValue<bool>( g_isShadowCatcherAttributeName, attributes, m_isShadowCatcher );
 			m_shadowTerminatorShadingOffset = attributeValue<float>( g_shadowTerminatorShadingOffsetAttributeName, attributes, m_shadowTerminatorShadingOffset );
 			m_shadowTerminatorGeometryOffset = attributeValue<float>( g_shadowTerminatorGeometryOffsetAttributeName, attributes, m_shadowTerminatorGeometryOffset );
+			m_autoNormals = attributeValue<bool>( g_autoNormalsAttributeName, attributes, m_autoNormals );
+			m_byteColors = attributeValue<std::string>( g_colorPrecisionAttributeName, attributes, "float" ) == "byte";
+			m_curveDensity = attributeValue<float>( g_curveDensityAttributeName, attributes, m_curveDensity );
+			m_curvesPerPixel = attributeValue<float>( g_curvesPerPixelAttributeName, attributes, m_curvesPerPixel );
+			m_velocityBlur = attributeValue<bool>( g_velocityBlurAttributeName, attributes, m_velocityBlur );
+			m_velocityScale = attributeValue<float>( g_velocityScaleAttributeName, attributes, m_velocityScale );
+			m_motionTolerance = attributeValue<float>( g_motionToleranceAttributeName, attributes, m_motionTolerance );
+			m_motionPixelTolerance = attributeValue<float>( g_motionPixelToleranceAttributeName, attributes, m_motionPixelTolerance );
 			m_maxLevel = attributeValue<int>( g_maxLevelAttributeName, attributes, m_maxLevel );
 			m_dicingRate = attributeValue<float>( g_dicingRateAttributeName, attributes, m_dicingRate );
+			m_subdivisionInstancing = attributeValue<bool>( g_subdivisionInstancingAttributeName, attributes, m_subdivisionInstancing );
 			m_color = attributeValue<Color3f>( g_colorAttributeName, attributes, m_color );
 			m_dupliGenerated = attributeValue<V3f>( g_dupliGeneratedAttributeName, attributes, m_dupliGenerated );
 			m_dupliUV = attributeValue<V2f>( g_dupliUVAttributeName, attributes, m_dupliUV );
@@ -1055,16 +1768,47 @@ class CyclesAttributes : public IECoreScenePreview::Renderer::AttributesInterfac
 
 				if( ccl::Mesh *mesh = (ccl::Mesh*)object->get_geometry() )
 				{
+					if( previousAttributes->m_velocityBlur != m_velocityBlur || previousAttributes->m_velocityScale != m_velocityScale )
+					{
+						// Motion is synthesised during conversion
+						return false;
+					}
+
+					if( previousAttributes->m_motionTolerance != m_motionTolerance || previousAttributes->m_motionPixelTolerance != m_motionPixelTolerance )
+					{
+						// Motion samples are chosen during conversion
+						return false;
+					}
+
 					if( mesh->geometry_type == ccl::Geometry::MESH )
 					{
 						if( ccl::SubdParams *params = mesh->get_subd_params() )
 						{
-							if( ( previousAttributes->m_maxLevel != m_maxLevel ) || ( previousAttributes->m_dicingRate != m_dicingRate ) )
+							if( ( previousAttributes->m_maxLevel != m_maxLevel ) || ( previousAttributes->m_dicingRate != m_dicingRate ) || ( previousAttributes->m_subdivisionInstancing != m_subdivisionInstancing ) )
 							{
 								// Get a new mesh
 								return false;
 							}
 						}
+						else if( previousAttributes->m_autoNormals != m_autoNormals )
+						{
+							// Normals are generated during conversion
+							return false;
+						}
+
+						if( previousAttributes->m_byteColors != m_byteColors )
+						{
+							// Colours are packed during conversion
+							return false;
+						}
+					}
+					else if( mesh->geometry_type == ccl::Geometry::HAIR )
+					{
+						if( previousAttributes->m_curveDensity != m_curveDensity || previousAttributes->m_curvesPerPixel != m_curvesPerPixel )
+						{
+							// Curves are thinned during conversion
+							return false;
+						}
 					}
 				}
 			}
@@ -1113,6 +1857,22 @@ class CyclesAttributes : public IECoreScenePreview::Renderer::AttributesInterfac
 								return false;
 							}
 						}
+						for( const auto &uvSet : tangentUVSets() )
+						{
+							if( !attributes.find( ccl::ustring( uvSet.first.c_str() ) ) )
+							{
+								// Can't generate tangents for a UV set we don't have
+								continue;
+							}
+							if(
+								!attributes.find( ccl::ustring( ( uvSet.first + ".tangent" ).c_str() ) ) ||
+								( uvSet.second && !attributes.find( ccl::ustring( ( uvSet.first + ".tangent_sign" ).c_str() ) ) )
+							)
+							{
+								// Re-issue new mesh with tangents for this UV set
+								return false;
+							}
+						}
 					}
 				}
 
@@ -1124,12 +1884,14 @@ class CyclesAttributes : public IECoreScenePreview::Renderer::AttributesInterfac
 				}
 			}
 
-			if( !m_particle.apply( object ) )
+			if( !m_particle.apply( object, m_particleSystemsCache ) )
 				return false;
 
 			if( !m_volume.apply( object ) )
 				return false;
 
+			m_customAttributes.apply( object, previousAttributes ? &previousAttributes->m_customAttributes : nullptr );
+
 #ifdef WITH_CYCLES_LIGHTGROUPS
 			object->set_lightgroup( ccl::ustring( m_lightGroup.c_str() ) );
 #endif
@@ -1137,15 +1899,27 @@ class CyclesAttributes : public IECoreScenePreview::Renderer::AttributesInterfac
 			return true;
 		}
 
-		void applyGeometry( const IECore::Object *object, ccl::Object *cobject ) const
+		// Returns the number of bytes saved by storing colours as bytes.
+		size_t applyGeometry( const IECore::Object *object, ccl::Object *cobject ) const
 		{
-			if( needTangents() )
+			size_t colorBytesSaved = 0;
+			if( const IECoreScene::MeshPrimitive *mesh = IECore::runTimeCast<const IECoreScene::MeshPrimitive>( object ) )
 			{
-				if( const IECoreScene::MeshPrimitive *mesh = IECore::runTimeCast<const IECoreScene::MeshPrimitive>( object ) )
+				ccl::Mesh *cmesh = static_cast<ccl::Mesh*>( cobject->get_geometry() );
+				if( m_byteColors )
+				{
+					colorBytesSaved = AttributeAlgo::convertColorsToBytes( cmesh->get_num_subd_faces() ? cmesh->subd_attributes : cmesh->attributes );
+				}
+				if( needTangents() )
 				{
-					MeshAlgo::computeTangents( static_cast<ccl::Mesh*>( cobject->get_geometry() ), mesh, needTangentSign() );
+					MeshAlgo::computeTangents( cmesh, mesh, needTangentSign() );
+				}
+				for( const auto &uvSet : tangentUVSets() )
+				{
+					MeshAlgo::computeTangents( cmesh, uvSet.first, uvSet.second );
 				}
 			}
+			return colorBytesSaved;
 		}
 
 		bool applyLight( ccl::Light *light, const CyclesAttributes *previousAttributes ) const
@@ -1192,8 +1966,12 @@ class CyclesAttributes : public IECoreScenePreview::Renderer::AttributesInterfac
 		// Generates a signature for the work done by applyGeometry.
 		void hashGeometry( const IECore::Object *object, IECore::MurmurHash &h ) const
 		{
-			// Currently Cycles can only have a shader assigned uniquely and not instanced...
-			//h.append( m_shaderHash );
+			// Cycles assigns shaders to geometry rather than to objects, so
+			// geometry can only be shared between objects with the same shaders.
+			// This is the identity of the shader in the ShaderCache. An object
+			// that isn't re-issued because its edit will be applied in place (see
+			// `shaderEditedInPlace()`) keeps its geometry.
+			h.append( m_shaderHash );
 			const IECore::TypeId objectType = object->typeId();
 			switch( (int)objectType )
 			{
@@ -1203,12 +1981,22 @@ class CyclesAttributes : public IECoreScenePreview::Renderer::AttributesInterfac
 						h.append( m_dicingRate );
 						h.append( m_maxLevel );
 					}
+					else
+					{
+						h.append( m_autoNormals );
+					}
+					h.append( m_byteColors );
 					if( m_shader )
 					{
 						if( needTangents() )
 							h.append( "tangent" );
 						if( needTangentSign() )
 							h.append( "tangent_sign" );
+						for( const auto &uvSet : tangentUVSets() )
+						{
+							h.append( uvSet.first );
+							h.append( uvSet.second );
+						}
 					}
 					break;
 				case IECoreScene::CurvesPrimitiveTypeId :
@@ -1237,8 +2025,11 @@ class CyclesAttributes : public IECoreScenePreview::Renderer::AttributesInterfac
 			{
 				if( mesh->interpolation() == "catmullClark" )
 				{
-					// For now we treat all subdiv surfaces as unique because they are all treated as adaptive.
-					return false;
+					// Subdivision surfaces are adaptive, so by default they're unique.
+					// When instancing is requested, identical meshes share one
+					// tessellation, diced for the instance closest to the dicing
+					// camera. See `InstanceCache::updateSubdivisionInstances()`.
+					return m_subdivisionInstancing;
 				}
 				else
 				{
@@ -1254,59 +2045,196 @@ class CyclesAttributes : public IECoreScenePreview::Renderer::AttributesInterfac
 			return m_particle.hasParticleInfo();
 		}
 
-		bool needTangents() const
+		const IECore::MurmurHash &shaderHash() const
 		{
-			if( !m_shader )
-				return false;
-			return m_shader->shader()->attributes.find( ccl::ATTR_STD_UV_TANGENT );
+			return m_shaderHash;
 		}
 
-		bool needTangentSign() const
+		// Returns true if our shader differs from that of `previous` only by
+		// network parameter values, and the object moving from `previous` to
+		// us is the last user of the previous shader. The ShaderCache then
+		// updates the previous `ccl::Shader` in place, so geometry shared with
+		// the object keeps the correct assignment. If anything else still uses
+		// the previous shader it won't be adopted, and the object must be
+		// re-issued instead.
+		bool shaderEditedInPlace( const CyclesAttributes *previous ) const
 		{
-			if( !m_shader )
+			if( !m_shader || !previous->m_shader )
+			{
 				return false;
-			return m_shader->shader()->attributes.find( ccl::ATTR_STD_UV_TANGENT_SIGN );
-		}
+			}
 
-		void nodesCreated( NodesCreated &nodes )
-		{
-			m_shader->nodesCreated( nodes );
-		}
+			// One reference is held by the ShaderCache and the other by
+			// `previous`, which must be used only by the calling object.
+			if( previous->m_shader->refCount() > 2 || previous->m_numObjects > 1 )
+			{
+				return false;
+			}
 
-	private :
+			return m_shader->sharingHash() == previous->m_shader->sharingHash();
+		}
 
-		template<typename T>
-		static const T *attribute( const IECore::InternedString &name, const IECore::CompoundObject *attributes )
+		// Called by CyclesObject as it starts and stops using these
+		// attributes, so that `shaderEditedInPlace()` can tell when
+		// other objects share them.
+		void objectAdded() const
 		{
-			IECore::CompoundObject::ObjectMap::const_iterator it = attributes->members().find( name );
-			if( it == attributes->members().end() )
-			{
-				return nullptr;
-			}
-			return reportedCast<const T>( it->second.get(), "attribute", name );
+			m_numObjects++;
 		}
 
-		template<typename T>
-		static T attributeValue( const IECore::InternedString &name, const IECore::CompoundObject *attributes, const T &defaultValue )
+		void objectRemoved() const
 		{
-			typedef IECore::TypedData<T> DataType;
-			const DataType *data = attribute<DataType>( name, attributes );
-			return data ? data->readable() : defaultValue;
+			m_numObjects--;
 		}
 
-		template<typename T>
-		static boost::optional<T> optionalAttribute( const IECore::InternedString &name, const IECore::CompoundObject *attributes )
+		// Returns true if Cycles should generate normals for meshes
+		// without them, rather than us generating them during conversion.
+		bool autoNormals() const
 		{
-			typedef IECore::TypedData<T> DataType;
-			const DataType *data = attribute<DataType>( name, attributes );
-			return data ? data->readable() : boost::optional<T>();
+			return m_autoNormals;
 		}
 
-		void updateVisibility( const IECore::InternedString &name, int rayType, const IECore::CompoundObject *attributes )
+		// Returns the proportion of the curves in `object` to keep, taking
+		// into account its size as seen by `camera` when
+		// `ccl:curves_per_pixel` is set. Returns 1 for other objects.
+		float curveDensity( const IECore::Object *object, const Imath::M44f &transform, const LODCamera &camera ) const
 		{
-			if( const IECore::BoolData *d = attribute<IECore::BoolData>( name, attributes ) )
+			const IECoreScene::CurvesPrimitive *curves = IECore::runTimeCast<const IECoreScene::CurvesPrimitive>( object );
+			if( !curves )
 			{
-				if( d->readable() )
+				return 1.0f;
+			}
+
+			float density = m_curveDensity;
+			if( m_curvesPerPixel > 0.0f && camera.valid && curves->numCurves() )
+			{
+				const float size = camera.projectedSize( Imath::transform( curves->bound(), transform ) );
+				const float autoDensity = m_curvesPerPixel * size * size / (float)curves->numCurves();
+				if( autoDensity < 1.0f )
+				{
+					// Quantise to half octaves, so that the density changes
+					// rarely as objects move, and instances at similar
+					// distances can share geometry.
+					density *= std::pow( 2.0f, std::ceil( std::log2( autoDensity ) * 2.0f ) / 2.0f );
+				}
+			}
+
+			return std::min( std::max( density, 0.0f ), 1.0f );
+		}
+
+		// The surface shader, or null if the object has none.
+		CyclesShaderPtr shader() const
+		{
+			return m_shader;
+		}
+
+		// Returns the scale to apply to "velocity" primitive variables when
+		// synthesising motion, or 0 if `ccl:velocity_blur` is off.
+		float velocityScale() const
+		{
+			return m_velocityBlur ? m_velocityScale : 0.0f;
+		}
+
+		// Returns the world space distance within which motion samples
+		// may be replaced by interpolating between their neighbours, taking
+		// into account the size of `object` as seen by `camera` when
+		// `ccl:motion_pixel_tolerance` is set. Returns 0 if all motion
+		// samples should be kept.
+		float motionTolerance( const IECore::Object *object, const Imath::M44f &transform, const LODCamera &camera ) const
+		{
+			float tolerance = m_motionTolerance;
+			if( m_motionPixelTolerance > 0.0f && camera.valid )
+			{
+				if( const IECoreScene::Primitive *primitive = IECore::runTimeCast<const IECoreScene::Primitive>( object ) )
+				{
+					tolerance = std::max( tolerance, camera.worldSize( m_motionPixelTolerance, Imath::transform( primitive->bound(), transform ) ) );
+				}
+			}
+
+			return std::max( tolerance, 0.0f );
+		}
+
+		bool needTangents() const
+		{
+			if( !m_shader )
+				return false;
+			return m_shader->shader()->attributes.find( ccl::ATTR_STD_UV_TANGENT );
+		}
+
+		bool needTangentSign() const
+		{
+			if( !m_shader )
+				return false;
+			return m_shader->shader()->attributes.find( ccl::ATTR_STD_UV_TANGENT_SIGN );
+		}
+
+		// Maps from the name of a UV set to whether or not the tangent
+		// sign is needed as well as the tangent.
+		typedef std::map<std::string, bool> TangentUVSets;
+
+		// Returns the UV sets, other than the default one, for which the
+		// shader needs tangents. Normal map and tangent nodes request these
+		// as "<uvSet>.tangent" and "<uvSet>.tangent_sign".
+		TangentUVSets tangentUVSets() const
+		{
+			TangentUVSets result;
+			if( !m_shader )
+				return result;
+
+			for( const ccl::AttributeRequest &request : m_shader->shader()->attributes.requests )
+			{
+				const std::string &name = request.name.string();
+				if( boost::ends_with( name, ".tangent_sign" ) )
+				{
+					result[name.substr( 0, name.size() - 13 )] = true;
+				}
+				else if( boost::ends_with( name, ".tangent" ) )
+				{
+					result.insert( { name.substr( 0, name.size() - 8 ), false } );
+				}
+			}
+			return result;
+		}
+
+		void nodesCreated( NodesCreated &nodes )
+		{
+			m_shader->nodesCreated( nodes );
+		}
+
+	private :
+
+		template<typename T>
+		static const T *attribute( const IECore::InternedString &name, const IECore::CompoundObject *attributes )
+		{
+			IECore::CompoundObject::ObjectMap::const_iterator it = attributes->members().find( name );
+			if( it == attributes->members().end() )
+			{
+				return nullptr;
+			}
+			return reportedCast<const T>( it->second.get(), "attribute", name );
+		}
+
+		template<typename T>
+		static T attributeValue( const IECore::InternedString &name, const IECore::CompoundObject *attributes, const T &defaultValue )
+		{
+			typedef IECore::TypedData<T> DataType;
+			const DataType *data = attribute<DataType>( name, attributes );
+			return data ? data->readable() : defaultValue;
+		}
+
+		template<typename T>
+		static boost::optional<T> optionalAttribute( const IECore::InternedString &name, const IECore::CompoundObject *attributes )
+		{
+			typedef IECore::TypedData<T> DataType;
+			const DataType *data = attribute<DataType>( name, attributes );
+			return data ? data->readable() : boost::optional<T>();
+		}
+
+		void updateVisibility( const IECore::InternedString &name, int rayType, const IECore::CompoundObject *attributes )
+		{
+			if( const IECore::BoolData *d = attribute<IECore::BoolData>( name, attributes ) )
+			{
+				if( d->readable() )
 				{
 					m_visibility |= rayType;
 				}
@@ -1372,34 +2300,32 @@ class CyclesAttributes : public IECoreScenePreview::Renderer::AttributesInterfac
 				}
 			}
 
-			bool apply( ccl::Object *object ) const
+			bool apply( ccl::Object *object, ParticleSystemsCache *particleSystemsCache ) const
 			{
 				if( !hasParticleInfo() )
 				{
 					return true;
 				}
-				else if( ccl::ParticleSystem *psys = object->get_particle_system() )
+				else if( object->get_particle_system() )
 				{
-					size_t idx = object->get_particle_index();
-					if( idx < psys->particles.size() )
-					{
-						if( index )
-							psys->particles[idx].index = index.get();
-						if( age )
-							psys->particles[idx].age = age.get();
-						if( lifetime )
-							psys->particles[idx].lifetime = lifetime.get();
-						if( location )
-							psys->particles[idx].location = SocketAlgo::setVector( location.get() );
-						if( rotation )
-							psys->particles[idx].rotation = SocketAlgo::setQuaternion( rotation.get() );
-						if( size )
-							psys->particles[idx].size = size.get();
-						if( velocity )
-							psys->particles[idx].velocity = SocketAlgo::setVector( velocity.get() );
-						if( angular_velocity )
-							psys->particles[idx].angular_velocity = SocketAlgo::setVector( angular_velocity.get() );
-					}
+					ccl::Particle particle = {};
+					if( index )
+						particle.index = index.get();
+					if( age )
+						particle.age = age.get();
+					if( lifetime )
+						particle.lifetime = lifetime.get();
+					if( location )
+						particle.location = SocketAlgo::setVector( location.get() );
+					if( rotation )
+						particle.rotation = SocketAlgo::setQuaternion( rotation.get() );
+					if( size )
+						particle.size = size.get();
+					if( velocity )
+						particle.velocity = SocketAlgo::setVector( velocity.get() );
+					if( angular_velocity )
+						particle.angular_velocity = SocketAlgo::setVector( angular_velocity.get() );
+					particleSystemsCache->setParticle( object, particle );
 					return true;
 				}
 				else
@@ -1439,6 +2365,84 @@ class CyclesAttributes : public IECoreScenePreview::Renderer::AttributesInterfac
 
 		};
 
+		// Per-object `user:*` and `render:*` attributes, which can be
+		// read by the Attribute shader node without making the geometry
+		// unique.
+		struct CustomAttributes
+		{
+			CustomAttributes( const IECore::CompoundObject *attributes )
+			{
+				for( const auto &member : attributes->members() )
+				{
+					const std::string &name = member.first.string();
+					if( !boost::starts_with( name, g_customAttributePrefixes[0] ) && !boost::starts_with( name, g_customAttributePrefixes[1] ) )
+					{
+						continue;
+					}
+
+					const ccl::ustring cname( name.c_str() );
+					switch( member.second->typeId() )
+					{
+						case IECore::FloatDataTypeId :
+							add( cname, ccl::TypeDesc::TypeFloat, &static_cast<const IECore::FloatData *>( member.second.get() )->readable(), 1 );
+							break;
+						case IECore::IntDataTypeId :
+						{
+							const float f = static_cast<const IECore::IntData *>( member.second.get() )->readable();
+							add( cname, ccl::TypeDesc::TypeFloat, &f, 1 );
+							break;
+						}
+						case IECore::BoolDataTypeId :
+						{
+							const float f = static_cast<const IECore::BoolData *>( member.second.get() )->readable() ? 1.0f : 0.0f;
+							add( cname, ccl::TypeDesc::TypeFloat, &f, 1 );
+							break;
+						}
+						case IECore::V2fDataTypeId :
+							add( cname, ccl::TypeDesc::TypeFloat2, static_cast<const IECore::V2fData *>( member.second.get() )->readable().getValue(), 2 );
+							break;
+						case IECore::V3fDataTypeId :
+							add( cname, ccl::TypeDesc::TypeVector, static_cast<const IECore::V3fData *>( member.second.get() )->readable().getValue(), 3 );
+							break;
+						case IECore::Color3fDataTypeId :
+							add( cname, ccl::TypeDesc::TypeColor, static_cast<const IECore::Color3fData *>( member.second.get() )->readable().getValue(), 3 );
+							break;
+						case IECore::Color4fDataTypeId :
+							add( cname, ccl::TypeDesc::TypeFloat4, static_cast<const IECore::Color4fData *>( member.second.get() )->readable().getValue(), 4 );
+							break;
+						default :
+							// Not representable as a Cycles object attribute.
+							break;
+					}
+				}
+			}
+
+			ccl::vector<ccl::ParamValue> values;
+			IECore::MurmurHash hash;
+
+			void apply( ccl::Object *object, const CustomAttributes *previous ) const
+			{
+				if( previous && previous->hash == hash )
+				{
+					return;
+				}
+
+				// Not a socket, but `Object::tag_update()` always flags the
+				// GeometryManager, which is where these get packed.
+				object->attributes = values;
+			}
+
+			private :
+
+				void add( const ccl::ustring &name, ccl::TypeDesc type, const float *data, size_t size )
+				{
+					values.emplace_back( name, type, 1, data );
+					hash.append( name.c_str() );
+					hash.append( data, size );
+				}
+
+		};
+
 		struct ShaderAttributes
 		{
 			ShaderAttributes( const IECore::CompoundObject *attributes )
@@ -1508,18 +2512,31 @@ class CyclesAttributes : public IECoreScenePreview::Renderer::AttributesInterfac
 		bool m_isShadowCatcher;
 		float m_shadowTerminatorShadingOffset;
 		float m_shadowTerminatorGeometryOffset;
+		bool m_autoNormals;
+		bool m_byteColors;
+		float m_curveDensity;
+		float m_curvesPerPixel;
+		bool m_velocityBlur;
+		float m_velocityScale;
+		float m_motionTolerance;
+		float m_motionPixelTolerance;
 		int m_maxLevel;
 		float m_dicingRate;
+		bool m_subdivisionInstancing;
 		Color3f m_color;
 		V3f m_dupliGenerated;
 		V2f m_dupliUV;
 		Particle m_particle;
 		Volume m_volume;
+		CustomAttributes m_customAttributes;
 		ShaderAttributes m_shaderAttributes;
 		InternedString m_assetName;
 		InternedString m_lightGroup;
 		// Need to assign shaders in a deferred manner
 		ShaderCache *m_shaderCache;
+		// Particle info is merged at the scene lock too
+		ParticleSystemsCache *m_particleSystemsCache;
+		mutable std::atomic<int> m_numObjects;
 
 };
 
@@ -1539,8 +2556,8 @@ class AttributesCache : public IECore::RefCounted
 
 	public :
 
-		AttributesCache( ShaderCachePtr shaderCache )
-			: m_shaderCache( shaderCache )
+		AttributesCache( ShaderCachePtr shaderCache, ParticleSystemsCachePtr particleSystemsCache )
+			: m_shaderCache( shaderCache ), m_particleSystemsCache( particleSystemsCache )
 		{
 		}
 
@@ -1551,7 +2568,7 @@ class AttributesCache : public IECore::RefCounted
 			m_cache.insert( a, attributes->Object::hash() );
 			if( !a->second )
 			{
-				a->second = new CyclesAttributes( attributes, m_shaderCache.get() );
+				a->second = new CyclesAttributes( attributes, m_shaderCache.get(), m_particleSystemsCache.get() );
 			}
 			return a->second;
 		}
@@ -1581,6 +2598,7 @@ class AttributesCache : public IECore::RefCounted
 	private :
 
 		ShaderCachePtr m_shaderCache;
+		ParticleSystemsCachePtr m_particleSystemsCache;
 
 		typedef tbb::concurrent_hash_map<IECore::MurmurHash, CyclesAttributesPtr> Cache;
 		Cache m_cache;
@@ -1591,129 +2609,6 @@ IE_CORE_DECLAREPTR( AttributesCache )
 
 } // namespace
 
-//////////////////////////////////////////////////////////////////////////
-// ParticleSystemCache
-//////////////////////////////////////////////////////////////////////////
-
-namespace
-{
-
-class ParticleSystemsCache : public IECore::RefCounted
-{
-
-	public :
-
-		ParticleSystemsCache( ccl::Scene *scene ) : m_scene( scene )
-		{
-		}
-
-		void update( ccl::Scene *scene, NodesCreated &psys )
-		{
-			m_scene = scene;
-			updateParticleSystems( psys );
-		}
-
-		// Can be called concurrently with other get() calls.
-		SharedCParticleSystemPtr get( const IECoreScene::PointsPrimitive *points )
-		{
-			const IECore::MurmurHash hash = points->Object::hash();
-
-			Cache::accessor a;
-			m_cache.insert( a, hash );
-
-			if( !a->second )
-			{
-				a->second = SharedCParticleSystemPtr( ParticleAlgo::convert( points ), nullNodeDeleter );
-			}
-
-			return a->second;
-		}
-
-		// For unique attributes on instanced meshes.
-		SharedCParticleSystemPtr get( const IECore::MurmurHash hash )
-		{
-			Cache::accessor a;
-			m_cache.insert( a, hash );
-			ccl::Particle particle = {};
-
-			if( !a->second )
-			{
-				ccl::ParticleSystem *pSys = new ccl::ParticleSystem();
-				pSys->particles.push_back_slow( particle );
-				a->second = SharedCParticleSystemPtr( pSys, nullNodeDeleter );
-			}
-			else
-			{
-				a->second->particles.push_back_slow( particle );
-			}
-
-			a->second->tag_update( m_scene );
-
-			return a->second;
-		}
-
-		// Must not be called concurrently with anything.
-		void clearUnused()
-		{
-			vector<IECore::MurmurHash> toErase;
-			for( Cache::iterator it = m_cache.begin(), eIt = m_cache.end(); it != eIt; ++it )
-			{
-				if( it->second.unique() )
-				{
-					// Only one reference - this is ours, so
-					// nothing outside of the cache is using the
-					// camera.
-					toErase.push_back( it->first );
-				}
-			}
-			for( vector<IECore::MurmurHash>::const_iterator it = toErase.begin(), eIt = toErase.end(); it != eIt; ++it )
-			{
-				m_cache.erase( *it );
-			}
-
-			if( toErase.size() )
-			{
-				m_scene->particle_system_manager->tag_update( m_scene );
-			}
-		}
-
-		void nodesCreated( NodesCreated &nodes ) const
-		{
-			for( Cache::const_iterator it = m_cache.begin(), eIt = m_cache.end(); it != eIt; ++it )
-			{
-				if( it->second.get() )
-				{
-					nodes.push_back( it->second.get() );
-				}
-			}
-		}
-
-	private :
-
-		void updateParticleSystems( NodesCreated &nodes )
-		{
-			if( nodes.size() )
-			{
-				ccl::vector<ccl::ParticleSystem *> &particleSystems = m_scene->particle_systems;
-				for( ccl::Node *node : nodes )
-				{
-					particleSystems.push_back( static_cast<ccl::ParticleSystem *>( node ) );
-				}
-				m_scene->particle_system_manager->tag_update( m_scene );
-				nodes.clear();
-			}
-		}
-
-		ccl::Scene *m_scene;
-		typedef tbb::concurrent_hash_map<IECore::MurmurHash, SharedCParticleSystemPtr> Cache;
-		Cache m_cache;
-
-};
-
-IE_CORE_DECLAREPTR( ParticleSystemsCache )
-
-} // namespace
-
 //////////////////////////////////////////////////////////////////////////
 // InstanceCache
 //////////////////////////////////////////////////////////////////////////
@@ -1736,9 +2631,9 @@ class Instance
 			return m_geometry.get();
 		}
 
-		ccl::ParticleSystem *particleSystem()
+		bool uniqueGeometry() const
 		{
-			return m_particleSystem.get();
+			return m_uniqueGeometry;
 		}
 
 		void objectsCreated( NodesCreated &nodes ) const
@@ -1754,34 +2649,24 @@ class Instance
 			}
 		}
 
-		void particleSystemsCreated( NodesCreated &nodes ) const
-		{
-			if( m_prototype && m_particleSystem )
-			{
-				nodes.push_back( m_particleSystem.get() );
-			}
-		}
-
 	private :
 
 		// Constructors are private as they are only intended for use in
 		// `InstanceCache::get()`. See comment in `nodesCreated()`.
 		friend class InstanceCache;
 
-		Instance( const SharedCObjectPtr &object, const SharedCGeometryPtr &geometry, const bool prototype )
-			:	m_object( object ), m_geometry( geometry ), m_prototype( prototype )
-		{
-		}
-
-		Instance( const SharedCObjectPtr &object, const SharedCGeometryPtr &geometry, const SharedCParticleSystemPtr &particleSystem, const bool prototype )
-			:	m_object( object ), m_geometry( geometry ), m_particleSystem( particleSystem ), m_prototype( prototype )
+		Instance( const SharedCObjectPtr &object, const SharedCGeometryPtr &geometry, const bool prototype, const IECore::MurmurHash &geometryHash, const bool uniqueGeometry )
+			:	m_object( object ), m_geometry( geometry ), m_prototype( prototype ),
+				m_geometryHash( geometryHash ), m_uniqueGeometry( uniqueGeometry )
 		{
 		}
 
 		SharedCObjectPtr m_object;
 		SharedCGeometryPtr m_geometry;
-		SharedCParticleSystemPtr m_particleSystem;
 		bool m_prototype;
+		// Used by `InstanceCache::retire()`.
+		IECore::MurmurHash m_geometryHash;
+		bool m_uniqueGeometry;
 
 };
 
@@ -1791,7 +2676,7 @@ class InstanceCache : public IECore::RefCounted
 	public :
 
 		InstanceCache( ccl::Scene *scene, ParticleSystemsCachePtr particleSystemsCache )
-			: m_scene( scene ), m_particleSystemsCache( particleSystemsCache )
+			: m_scene( scene ), m_particleSystemsCache( particleSystemsCache ), m_subdivisionInstancesDirty( false ), m_subdivisionCameraMatrix( ccl::transform_identity() ), m_colorBytesSaved( 0 )
 		{
 		}
 
@@ -1802,34 +2687,37 @@ class InstanceCache : public IECore::RefCounted
 			updateGeometry( geometry );
 		}
 
-		// Can be called concurrently with other get() calls.
-		Instance get( const IECore::Object *object, const IECoreScenePreview::Renderer::AttributesInterface *attributes, const std::string &nodeName )
+		// Can be called concurrently with other get() calls. Curves are
+		// thinned to `curveDensity`, as returned by `CyclesAttributes::curveDensity()`.
+		Instance get( const IECore::Object *object, const IECoreScenePreview::Renderer::AttributesInterface *attributes, const std::string &nodeName, float curveDensity = 1.0f )
 		{
 			const CyclesAttributes *cyclesAttributes = static_cast<const CyclesAttributes *>( attributes );
 
 			if( !cyclesAttributes->canInstanceGeometry( object ) )
 			{
-				SharedCParticleSystemPtr cpsysPtr;
-				SharedCObjectPtr cobject = convert( object, cyclesAttributes, nodeName, cpsysPtr );
-				m_objects.push_back( cobject );
+				SharedCObjectPtr cobject = convert( object, cyclesAttributes, nodeName, curveDensity );
+				m_objects.insert( cobject.get() );
 				SharedCGeometryPtr cgeo = SharedCGeometryPtr( cobject.get()->get_geometry(), nullNodeDeleter );
-				m_uniqueGeometry.push_back( cgeo );
-				return Instance( cobject, cgeo, cpsysPtr, true );
+				m_uniqueGeometry.insert( cgeo.get() );
+				return Instance( cobject, cgeo, true, IECore::MurmurHash(), true );
 			}
 
 			bool isPrototype = false;
 
 			IECore::MurmurHash h = object->hash();
 			cyclesAttributes->hashGeometry( object, h );
+			if( curveDensity < 1.0f )
+			{
+				h.append( curveDensity );
+			}
 
 			SharedCObjectPtr cobject;
 			SharedCGeometryPtr cgeo;
-			SharedCParticleSystemPtr cpsysPtr;
 			Geometry::const_accessor readAccessor;
 			if( m_geometry.find( readAccessor, h ) )
 			{
 				cgeo = readAccessor->second;
-				cobject = convert( object, cyclesAttributes, nodeName, cpsysPtr, cgeo.get() );
+				cobject = convert( object, cyclesAttributes, nodeName, curveDensity, cgeo.get() );
 				readAccessor.release();
 			}
 			else
@@ -1837,7 +2725,7 @@ class InstanceCache : public IECore::RefCounted
 				Geometry::accessor writeAccessor;
 				if( m_geometry.insert( writeAccessor, h ) )
 				{
-					cobject = convert( object, cyclesAttributes, nodeName, cpsysPtr );
+					cobject = convert( object, cyclesAttributes, nodeName, curveDensity );
 					writeAccessor->second = SharedCGeometryPtr( cobject->get_geometry(), nullNodeDeleter );
 					cgeo = writeAccessor->second;
 					cgeo->name = h.toString();
@@ -1846,14 +2734,19 @@ class InstanceCache : public IECore::RefCounted
 				else
 				{
 					cgeo = writeAccessor->second;
-					cobject = convert( object, cyclesAttributes, nodeName, cpsysPtr, cgeo.get() );
+					cobject = convert( object, cyclesAttributes, nodeName, curveDensity, cgeo.get() );
 				}
 				writeAccessor.release();
 			}
 
-			m_objects.push_back( cobject );
-
-			return Instance( cobject, cgeo, cpsysPtr, isPrototype );
+			m_objects.insert( cobject.get() );
+			if( isSubdivisionMesh( cgeo.get() ) )
+			{
+				m_subdivisionInstances.insert( cobject.get() );
+				m_subdivisionInstancesDirty = true;
+			}
+
+			return Instance( cobject, cgeo, isPrototype, h, false );
 		}
 
 		// Can be called concurrently with other get() calls.
@@ -1861,18 +2754,18 @@ class InstanceCache : public IECore::RefCounted
 					  const std::vector<float> &times, 
 					  const int frameIdx, 
 					  const IECoreScenePreview::Renderer::AttributesInterface *attributes, 
-					  const std::string &nodeName )
+					  const std::string &nodeName,
+					  float curveDensity = 1.0f )
 		{
 			const CyclesAttributes *cyclesAttributes = static_cast<const CyclesAttributes *>( attributes );
 
 			if( !cyclesAttributes->canInstanceGeometry( samples.front() ) )
 			{
-				SharedCParticleSystemPtr cpsysPtr;
-				SharedCObjectPtr cobject = convert( samples, times, frameIdx, cyclesAttributes, nodeName, cpsysPtr );
-				m_objects.push_back( cobject );
+				SharedCObjectPtr cobject = convert( samples, times, frameIdx, cyclesAttributes, nodeName, curveDensity );
+				m_objects.insert( cobject.get() );
 				SharedCGeometryPtr cgeo = SharedCGeometryPtr( cobject.get()->get_geometry(), nullNodeDeleter );
-				m_uniqueGeometry.push_back( cgeo );
-				return Instance( cobject, cgeo, cpsysPtr, true );
+				m_uniqueGeometry.insert( cgeo.get() );
+				return Instance( cobject, cgeo, true, IECore::MurmurHash(), true );
 			}
 
 			bool isPrototype = false;
@@ -1887,15 +2780,18 @@ class InstanceCache : public IECore::RefCounted
 				h.append( *it );
 			}
 			cyclesAttributes->hashGeometry( samples.front(), h );
+			if( curveDensity < 1.0f )
+			{
+				h.append( curveDensity );
+			}
 
 			SharedCObjectPtr cobject;
 			SharedCGeometryPtr cgeo;
-			SharedCParticleSystemPtr cpsysPtr;
 			Geometry::const_accessor readAccessor;
 			if( m_geometry.find( readAccessor, h ) )
 			{
 				cgeo = readAccessor->second;
-				cobject = convert( samples, times, frameIdx, cyclesAttributes, nodeName, cpsysPtr, cgeo.get() );
+				cobject = convert( samples, times, frameIdx, cyclesAttributes, nodeName, curveDensity, cgeo.get() );
 				readAccessor.release();
 			}
 			else
@@ -1903,7 +2799,7 @@ class InstanceCache : public IECore::RefCounted
 				Geometry::accessor writeAccessor;
 				if( m_geometry.insert( writeAccessor, h ) )
 				{
-					cobject = convert( samples, times, frameIdx, cyclesAttributes, nodeName, cpsysPtr );
+					cobject = convert( samples, times, frameIdx, cyclesAttributes, nodeName, curveDensity );
 					writeAccessor->second = SharedCGeometryPtr( cobject->get_geometry(), nullNodeDeleter );
 					cgeo = writeAccessor->second;
 					cgeo->name = h.toString();
@@ -1912,72 +2808,114 @@ class InstanceCache : public IECore::RefCounted
 				else
 				{
 					cgeo = writeAccessor->second;
-					cobject = convert( samples, times, frameIdx, cyclesAttributes, nodeName, cpsysPtr, cgeo.get() );
+					cobject = convert( samples, times, frameIdx, cyclesAttributes, nodeName, curveDensity, cgeo.get() );
 				}
 				writeAccessor.release();
 			}
 
-			m_objects.push_back( cobject );
+			m_objects.insert( cobject.get() );
+			if( isSubdivisionMesh( cgeo.get() ) )
+			{
+				m_subdivisionInstances.insert( cobject.get() );
+				m_subdivisionInstancesDirty = true;
+			}
 
-			return Instance( cobject, cgeo, cpsysPtr, isPrototype );
+			return Instance( cobject, cgeo, isPrototype, h, false );
+		}
+
+		// The memory saved by storing colours as bytes, for all the
+		// geometry currently in the scene.
+		size_t colorBytesSaved() const
+		{
+			return m_colorBytesSaved;
+		}
+
+		// Called when the handle owning `instance` is released.
+		// Can be called concurrently with anything except `clearUnused()`.
+		void retire( const Instance &instance )
+		{
+			m_retired.push_back( instance );
 		}
 
+		// Only visits instances retired since the last call, rather than
+		// every node in the cache.
 		// Must not be called concurrently with anything.
 		void clearUnused()
 		{
+			if( m_retired.empty() )
+			{
+				return;
+			}
+
 			ccl::set<ccl::Object*> toEraseObjs;
+			ccl::set<ccl::Geometry*> toEraseGeos;
+			std::set<IECore::MurmurHash> retiredGeometry;
 
-			for( Objects::iterator it = m_objects.begin(), eIt = m_objects.end(); it != eIt; ++it )
+			for( const Instance &instance : m_retired )
 			{
-				if( it->unique() )
+				// Objects are never shared between instances.
+				ccl::Object *object = instance.m_object.get();
+				toEraseObjs.insert( object );
+				m_objects.unsafe_erase( object );
+				if( m_subdivisionInstances.unsafe_erase( object ) )
 				{
-					// Only one reference - this is ours, so
-					// nothing outside of the cache is using the
-					// node.
-					//toErase.push_back( it->first );
-					toEraseObjs.insert( it->get() );
+					m_subdivisionInstancesDirty = true;
 				}
-			}
 
-			removeNodesInSet( toEraseObjs, m_objects );
-			m_scene->delete_nodes( toEraseObjs, m_scene );
+				if( instance.m_uniqueGeometry )
+				{
+					toEraseGeos.insert( instance.m_geometry.get() );
+					m_uniqueGeometry.unsafe_erase( instance.m_geometry.get() );
+				}
+				else
+				{
+					retiredGeometry.insert( instance.m_geometryHash );
+				}
 
-			ccl::set<ccl::Geometry*> toEraseGeos;
+				if( object->get_particle_system() )
+				{
+					m_particleSystemsCache->retire( object );
+				}
+			}
+
+			// Drop our references before checking which shared geometry is
+			// still in use.
+			m_retired.clear();
 
-			for( UniqueGeometry::iterator it = m_uniqueGeometry.begin(), eIt = m_uniqueGeometry.end(); it != eIt; ++it )
+			for( const IECore::MurmurHash &hash : retiredGeometry )
 			{
-				if( it->unique() )
+				Geometry::accessor a;
+				if( m_geometry.find( a, hash ) && a->second.unique() )
 				{
 					// Only one reference - this is ours, so
 					// nothing outside of the cache is using the
 					// node.
-					//toErase.push_back( it->first );
-					toEraseGeos.insert( it->get() );
+					toEraseGeos.insert( a->second.get() );
+					if( isSubdivisionMesh( a->second.get() ) )
+					{
+						m_subdivisionBounds.erase( static_cast<const ccl::Mesh *>( a->second.get() ) );
+					}
+					m_geometry.erase( a );
 				}
 			}
 
-			removeNodesInSet( toEraseGeos, m_uniqueGeometry );
-
-			vector<IECore::MurmurHash> toErase;
-
-			for( Geometry::iterator it = m_geometry.begin(), eIt = m_geometry.end(); it != eIt; ++it )
+			for( ccl::Geometry *geometry : toEraseGeos )
 			{
-				if( it->second.unique() )
+				ColorBytesSaved::const_accessor a;
+				if( m_geometryColorBytesSaved.find( a, geometry ) )
 				{
-					// Only one reference - this is ours, so
-					// nothing outside of the cache is using the
-					// node.
-					toErase.push_back( it->first );
-					toEraseGeos.insert( it->second.get() );
+					m_colorBytesSaved -= a->second;
+					m_geometryColorBytesSaved.erase( a );
 				}
 			}
 
-			for( vector<IECore::MurmurHash>::const_iterator it = toErase.begin(), eIt = toErase.end(); it != eIt; ++it )
+			m_scene->delete_nodes( toEraseObjs, m_scene );
+			if( toEraseGeos.size() )
 			{
-				m_geometry.erase( *it );
+				m_scene->delete_nodes( toEraseGeos, m_scene );
 			}
 
-			m_scene->delete_nodes( toEraseGeos, m_scene );
+			IECore::msg( IECore::Msg::Debug, "CyclesRenderer", boost::format( "Reclaimed %d objects and %d geometry." ) % toEraseObjs.size() % toEraseGeos.size() );
 		}
 
 		void nodesCreated( NodesCreated &objects, NodesCreated &geometry )
@@ -1986,21 +2924,96 @@ class InstanceCache : public IECore::RefCounted
 			geometryCreated( geometry );
 		}
 
+		// Called when the transform of an instance of a shared subdivision
+		// mesh changes. Can be called concurrently with anything except
+		// `updateSubdivisionInstances()`.
+		void subdivisionInstanceMoved()
+		{
+			m_subdivisionInstancesDirty = true;
+		}
+
+		// Shared subdivision meshes can only be diced once, so we dice each
+		// one for the instance with the largest projected size as seen from
+		// the dicing camera. Must not be called concurrently with anything.
+		void updateSubdivisionInstances( const ccl::Camera *camera )
+		{
+			const ccl::Transform cameraMatrix = camera->get_matrix();
+			if( !m_subdivisionInstancesDirty && cameraMatrix == m_subdivisionCameraMatrix )
+			{
+				return;
+			}
+			m_subdivisionInstancesDirty = false;
+			m_subdivisionCameraMatrix = cameraMatrix;
+
+			const ccl::float3 cameraPosition = ccl::transform_get_column( &cameraMatrix, 3 );
+
+			std::unordered_map<ccl::Mesh *, std::pair<float, const ccl::Object *>> dicingInstances;
+			for( const ccl::Object *object : m_subdivisionInstances )
+			{
+				ccl::Mesh *mesh = static_cast<ccl::Mesh *>( object->get_geometry() );
+
+				auto boundIt = m_subdivisionBounds.find( mesh );
+				if( boundIt == m_subdivisionBounds.end() )
+				{
+					ccl::BoundBox bound = ccl::BoundBox::empty;
+					for( const ccl::float3 &v : static_cast<const ccl::Mesh *>( mesh )->get_verts() )
+					{
+						bound.grow( v );
+					}
+					boundIt = m_subdivisionBounds.insert( std::make_pair( mesh, bound ) ).first;
+				}
+
+				const ccl::Transform &tfm = object->get_tfm();
+				const ccl::BoundBox bound = boundIt->second.transformed( &tfm );
+				const float distance = std::max( ccl::len( bound.center() - cameraPosition ), 1e-6f );
+				const float coverage = ccl::len( bound.size() ) / distance;
+
+				auto it = dicingInstances.insert( std::make_pair( mesh, std::make_pair( coverage, object ) ) ).first;
+				if( coverage > it->second.first )
+				{
+					it->second = std::make_pair( coverage, object );
+				}
+			}
+
+			for( const auto &dicingInstance : dicingInstances )
+			{
+				ccl::Mesh *mesh = dicingInstance.first;
+				const ccl::Transform &tfm = dicingInstance.second.second->get_tfm();
+				if( !( mesh->get_subd_objecttoworld() == tfm ) )
+				{
+					mesh->set_subd_objecttoworld( tfm );
+					mesh->tag_update( m_scene, true );
+				}
+			}
+		}
+
 	private :
 
 		SharedCObjectPtr convert( const IECore::Object *object, 
 								  const CyclesAttributes *attributes, 
 								  const std::string &nodeName, 
-								  SharedCParticleSystemPtr &cpsysPtr, 
+								  float curveDensity,
 								  ccl::Geometry *cgeo = nullptr )
 		{
 			ccl::Object *cobject = nullptr;
 
 			if( !cgeo )
 			{
-				cobject = ObjectAlgo::convert( object, nodeName, m_scene );
-				attributes->applyGeometry( object, cobject );
+				const IECoreScene::MeshPrimitive *mesh = IECore::runTimeCast<const IECoreScene::MeshPrimitive>( object );
+				if( mesh && attributes->autoNormals() )
+				{
+					cobject = MeshAlgo::convert( mesh, /* generateNormals = */ false, nodeName, m_scene );
+				}
+				else if( curveDensity < 1.0f && object->typeId() == IECoreScene::CurvesPrimitiveTypeId )
+				{
+					cobject = CurvesAlgo::convert( static_cast<const IECoreScene::CurvesPrimitive *>( object ), curveDensity, nodeName, m_scene );
+				}
+				else
+				{
+					cobject = ObjectAlgo::convert( object, nodeName, m_scene );
+				}
 				ccl::Geometry *cgeo = cobject->get_geometry();
+				addColorBytesSaved( cgeo, attributes->applyGeometry( object, cobject ) );
 				cgeo->set_owner( m_scene );
 			}
 			else
@@ -2017,10 +3030,9 @@ class InstanceCache : public IECore::RefCounted
 
 			if( attributes->hasParticleInfo() )
 			{
-				ParticlesMutex::scoped_lock lock( m_particlesMutex );
-				cpsysPtr = m_particleSystemsCache->get( rh );
-				cobject->set_particle_system( cpsysPtr.get() );
-				cobject->set_particle_index( cpsysPtr.get()->particles.size() - 1 );
+				// The particle index is allocated when the particle
+				// info is merged at the scene lock.
+				cobject->set_particle_system( m_particleSystemsCache->particleSystem() );
 			}
 
 			return SharedCObjectPtr( cobject, nullNodeDeleter );
@@ -2031,16 +3043,39 @@ class InstanceCache : public IECore::RefCounted
 								  const int frame, 
 								  const CyclesAttributes *attributes, 
 								  const std::string &nodeName, 
-								  SharedCParticleSystemPtr &cpsysPtr, 
+								  float curveDensity,
 								  ccl::Geometry *cgeo = nullptr )
 		{
 			ccl::Object *cobject = nullptr;
 
 			if( !cgeo )
 			{
-				cobject = ObjectAlgo::convert( samples, times, frame, nodeName, m_scene );
-				attributes->applyGeometry( samples.front(), cobject );
+				if( curveDensity < 1.0f && samples.front()->typeId() == IECoreScene::CurvesPrimitiveTypeId )
+				{
+					std::vector<const IECoreScene::CurvesPrimitive *> curves;
+					curves.reserve( samples.size() );
+					for( const IECore::Object *sample : samples )
+					{
+						curves.push_back( static_cast<const IECoreScene::CurvesPrimitive *>( sample ) );
+					}
+					cobject = CurvesAlgo::convert( curves, times, frame, curveDensity, nodeName, m_scene );
+				}
+				else if( samples.front()->typeId() == IECoreScene::MeshPrimitiveTypeId && attributes->autoNormals() )
+				{
+					std::vector<const IECoreScene::MeshPrimitive *> meshes;
+					meshes.reserve( samples.size() );
+					for( const IECore::Object *sample : samples )
+					{
+						meshes.push_back( static_cast<const IECoreScene::MeshPrimitive *>( sample ) );
+					}
+					cobject = MeshAlgo::convert( meshes, times, frame, /* generateNormals = */ false, nodeName, m_scene );
+				}
+				else
+				{
+					cobject = ObjectAlgo::convert( samples, times, frame, nodeName, m_scene );
+				}
 				ccl::Geometry *cgeo = cobject->get_geometry();
+				addColorBytesSaved( cgeo, attributes->applyGeometry( samples.front(), cobject ) );
 				cgeo->set_owner( m_scene );
 			}
 			else
@@ -2057,10 +3092,9 @@ class InstanceCache : public IECore::RefCounted
 
 			if( attributes->hasParticleInfo() )
 			{
-				ParticlesMutex::scoped_lock lock( m_particlesMutex );
-				cpsysPtr = m_particleSystemsCache->get( rh );
-				cobject->set_particle_system( cpsysPtr.get() );
-				cobject->set_particle_index( cpsysPtr.get()->particles.size() - 1 );
+				// The particle index is allocated when the particle
+				// info is merged at the scene lock.
+				cobject->set_particle_system( m_particleSystemsCache->particleSystem() );
 			}
 
 			return SharedCObjectPtr( cobject, nullNodeDeleter );
@@ -2098,25 +3132,24 @@ class InstanceCache : public IECore::RefCounted
 			}
 		}
 
+		static bool isSubdivisionMesh( const ccl::Geometry *geometry )
+		{
+			return geometry->geometry_type == ccl::Geometry::MESH && static_cast<const ccl::Mesh *>( geometry )->get_subdivision_type() != ccl::Mesh::SUBDIVISION_NONE;
+		}
+
 		void objectsCreated( NodesCreated &nodes ) const
 		{
-			for( Objects::const_iterator it = m_objects.begin(), eIt = m_objects.end(); it != eIt; ++it )
+			for( ccl::Object *object : m_objects )
 			{
-				if( it->get() )
-				{
-					nodes.push_back( it->get() );
-				}
+				nodes.push_back( object );
 			}
 		}
 
 		void geometryCreated( NodesCreated &nodes ) const
 		{
-			for( UniqueGeometry::const_iterator it = m_uniqueGeometry.begin(), eIt = m_uniqueGeometry.end(); it != eIt; ++it )
+			for( ccl::Geometry *geometry : m_uniqueGeometry )
 			{
-				if( it->get() )
-				{
-					nodes.push_back( it->get() );
-				}
+				nodes.push_back( geometry );
 			}
 			for( Geometry::const_iterator it = m_geometry.begin(), eIt = m_geometry.end(); it != eIt; ++it )
 			{
@@ -2127,16 +3160,37 @@ class InstanceCache : public IECore::RefCounted
 			}
 		}
 
+		void addColorBytesSaved( const ccl::Geometry *geometry, size_t bytes )
+		{
+			if( !bytes )
+			{
+				return;
+			}
+			m_colorBytesSaved += bytes;
+			m_geometryColorBytesSaved.insert( std::make_pair( geometry, bytes ) );
+		}
+
 		ccl::Scene *m_scene;
-		typedef tbb::concurrent_vector<SharedCObjectPtr> Objects;
+		typedef tbb::concurrent_unordered_set<ccl::Object *> Objects;
 		Objects m_objects;
 		typedef tbb::concurrent_hash_map<IECore::MurmurHash, SharedCGeometryPtr> Geometry;
 		Geometry m_geometry;
-		typedef tbb::concurrent_vector<SharedCGeometryPtr> UniqueGeometry;
+		typedef tbb::concurrent_unordered_set<ccl::Geometry *> UniqueGeometry;
 		UniqueGeometry m_uniqueGeometry;
+		typedef tbb::concurrent_vector<Instance> Retired;
+		Retired m_retired;
+		// Instances of shared subdivision meshes, and the object space
+		// bounds of those meshes. Used by `updateSubdivisionInstances()`.
+		tbb::concurrent_unordered_set<ccl::Object *> m_subdivisionInstances;
+		std::unordered_map<const ccl::Mesh *, ccl::BoundBox> m_subdivisionBounds;
+		std::atomic<bool> m_subdivisionInstancesDirty;
+		ccl::Transform m_subdivisionCameraMatrix;
 		ParticleSystemsCachePtr m_particleSystemsCache;
-		typedef tbb::spin_mutex ParticlesMutex;
-		ParticlesMutex m_particlesMutex;
+		// Savings from storing colours as bytes, per live geometry, so
+		// that the total can be reduced when geometry is deleted.
+		typedef tbb::concurrent_hash_map<const ccl::Geometry *, size_t> ColorBytesSaved;
+		ColorBytesSaved m_geometryColorBytesSaved;
+		std::atomic<size_t> m_colorBytesSaved;
 
 
 };
@@ -2176,40 +3230,45 @@ class LightCache : public IECore::RefCounted
 			light->tag_update( m_scene );
 			auto clight = SharedCLightPtr( light, nullNodeDeleter );
 
-			m_lights.push_back( clight );
+			m_lights.insert( light );
 
 			return clight;
 		}
 
+		// Called when the handle owning `light` is released.
+		// Can be called concurrently with anything except `clearUnused()`.
+		void retire( const SharedCLightPtr &light )
+		{
+			m_retired.push_back( light.get() );
+		}
+
+		// Only visits lights retired since the last call.
 		// Must not be called concurrently with anything.
 		void clearUnused()
 		{
-			ccl::set<ccl::Light*> toErase;
+			if( m_retired.empty() )
+			{
+				return;
+			}
 
-			for( Lights::iterator it = m_lights.begin(), eIt = m_lights.end(); it != eIt; ++it )
+			ccl::set<ccl::Light*> toErase;
+			for( ccl::Light *light : m_retired )
 			{
-				if( it->unique() )
-				{
-					// Only one reference - this is ours, so
-					// nothing outside of the cache is using the
-					// node.
-					//toErase.push_back( it->first );
-					toErase.insert( it->get() );
-				}
+				toErase.insert( light );
+				m_lights.unsafe_erase( light );
 			}
+			m_retired.clear();
 
-			removeNodesInSet( toErase, m_lights );
 			m_scene->delete_nodes( toErase, m_scene );
+
+			IECore::msg( IECore::Msg::Debug, "CyclesRenderer", boost::format( "Reclaimed %d lights." ) % toErase.size() );
 		}
 
 		void nodesCreated( NodesCreated &nodes ) const
 		{
-			for( Lights::const_iterator it = m_lights.begin(), eIt = m_lights.end(); it != eIt; ++it )
+			for( ccl::Light *light : m_lights )
 			{
-				if( it->get() )
-				{
-					nodes.push_back( it->get() );
-				}
+				nodes.push_back( light );
 			}
 		}
 
@@ -2230,8 +3289,10 @@ class LightCache : public IECore::RefCounted
 		}
 
 		ccl::Scene *m_scene;
-		typedef tbb::concurrent_vector<SharedCLightPtr> Lights;
+		typedef tbb::concurrent_unordered_set<ccl::Light *> Lights;
 		Lights m_lights;
+		typedef tbb::concurrent_vector<ccl::Light *> Retired;
+		Retired m_retired;
 
 };
 
@@ -2302,6 +3363,472 @@ IE_CORE_DECLAREPTR( CameraCache )
 
 } // namespace
 
+#ifdef WITH_ALEMBIC
+
+//////////////////////////////////////////////////////////////////////////
+// ProceduralCache
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// The settings for a `ccl::AlembicProcedural`. These are gathered when the
+// object is given to the renderer, but the node itself can only be created
+// with the scene lock held, so is made later by `ProceduralCache::update()`.
+struct AlembicProceduralData : public IECore::RefCounted
+{
+
+	AlembicProceduralData()
+		:	frame( 0.0f ), frameRate( 24.0f ), scale( 1.0f ), node( nullptr )
+	{
+	}
+
+	std::string fileName;
+	std::vector<std::string> objectPaths;
+	float frame;
+	float frameRate;
+	float scale;
+	CyclesShaderPtr shader;
+	ccl::AlembicProcedural *node;
+
+};
+
+IE_CORE_DECLAREPTR( AlembicProceduralData )
+
+// Owns the procedural nodes in the scene. Cycles generates the objects
+// and geometry for these itself, streaming them straight from the file.
+class ProceduralCache : public IECore::RefCounted
+{
+
+	public :
+
+		ProceduralCache( ccl::Scene *scene )
+			:	m_scene( scene )
+		{
+		}
+
+		// Can be called concurrently with other `add()` calls.
+		void add( const AlembicProceduralDataPtr &procedural )
+		{
+			m_pending.push_back( procedural );
+		}
+
+		// Creates the nodes for procedurals added since the last call. When
+		// `skipReleased` is true, procedurals that were released before ever
+		// being made are skipped. This must be false for batch renders, where
+		// Gaffer releases every object as soon as it is created.
+		// Must be called with the scene lock held, after shaders have
+		// been added to the scene.
+		void update( ccl::Scene *scene, bool skipReleased )
+		{
+			m_scene = scene;
+			for( const AlembicProceduralDataPtr &procedural : m_pending )
+			{
+				if( !skipReleased || procedural->refCount() > 1 )
+				{
+					createNode( procedural.get() );
+					m_procedurals.push_back( procedural );
+				}
+			}
+			m_pending.clear();
+		}
+
+		// Must not be called concurrently with anything.
+		void clearUnused()
+		{
+			std::vector<AlembicProceduralDataPtr> procedurals;
+			for( const AlembicProceduralDataPtr &procedural : m_procedurals )
+			{
+				if( procedural->refCount() == 1 )
+				{
+					// Only one reference - this is ours, so
+					// nothing outside of the cache is using the
+					// procedural.
+					m_scene->delete_node( procedural->node );
+				}
+				else
+				{
+					procedurals.push_back( procedural );
+				}
+			}
+			m_procedurals.swap( procedurals );
+		}
+
+		// Deletes all the nodes, so that the scene can be reset. They are
+		// created again by the next call to `update()`.
+		// Must be called with the scene lock held.
+		void clearNodes()
+		{
+			for( const AlembicProceduralDataPtr &procedural : m_procedurals )
+			{
+				m_scene->delete_node( procedural->node );
+				procedural->node = nullptr;
+				m_pending.push_back( procedural );
+			}
+			m_procedurals.clear();
+		}
+
+	private :
+
+		void createNode( AlembicProceduralData *procedural )
+		{
+			ccl::AlembicProcedural *node = m_scene->create_node<ccl::AlembicProcedural>();
+			node->set_filepath( ccl::ustring( procedural->fileName.c_str() ) );
+			node->set_frame( procedural->frame );
+			node->set_start_frame( procedural->frame );
+			node->set_end_frame( procedural->frame );
+			node->set_frame_rate( procedural->frameRate );
+			node->set_scale( procedural->scale );
+
+			ccl::array<ccl::Node *> shaders;
+			if( procedural->shader && procedural->shader->shader() )
+			{
+				procedural->shader->shader()->tag_used( m_scene );
+				shaders.push_back_slow( procedural->shader->shader() );
+			}
+
+			for( const std::string &path : procedural->objectPaths )
+			{
+				ccl::AlembicObject *object = node->get_or_create_object( ccl::ustring( path.c_str() ) );
+				object->set_used_shaders( shaders );
+			}
+
+			procedural->node = node;
+		}
+
+		ccl::Scene *m_scene;
+		tbb::concurrent_vector<AlembicProceduralDataPtr> m_pending;
+		std::vector<AlembicProceduralDataPtr> m_procedurals;
+
+};
+
+IE_CORE_DECLAREPTR( ProceduralCache )
+
+} // namespace
+
+#endif // WITH_ALEMBIC
+
+//////////////////////////////////////////////////////////////////////////
+// Velocity blur
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+const IECore::V3fVectorData *vertexVectorData( const IECoreScene::Primitive *primitive, const std::string &name, size_t size )
+{
+	auto it = primitive->variables.find( name );
+	if( it == primitive->variables.end() || it->second.indices )
+	{
+		return nullptr;
+	}
+
+	if( it->second.interpolation != IECoreScene::PrimitiveVariable::Vertex && it->second.interpolation != IECoreScene::PrimitiveVariable::Varying )
+	{
+		return nullptr;
+	}
+
+	const IECore::V3fVectorData *data = IECore::runTimeCast<const IECore::V3fVectorData>( it->second.data.get() );
+	return data && data->readable().size() == size ? data : nullptr;
+}
+
+// Makes a new primitive sharing the topology and primitive variables
+// of `primitive`, so that "P" can be replaced without copying the rest.
+IECoreScene::PrimitivePtr shallowCopy( const IECoreScene::Primitive *primitive )
+{
+	IECoreScene::PrimitivePtr result;
+	if( const IECoreScene::MeshPrimitive *mesh = IECore::runTimeCast<const IECoreScene::MeshPrimitive>( primitive ) )
+	{
+		IECoreScene::MeshPrimitivePtr meshCopy = new IECoreScene::MeshPrimitive( mesh->verticesPerFace(), mesh->vertexIds(), mesh->interpolation() );
+		meshCopy->setCorners( mesh->cornerIds(), mesh->cornerSharpnesses() );
+		meshCopy->setCreases( mesh->creaseLengths(), mesh->creaseIds(), mesh->creaseSharpnesses() );
+		result = meshCopy;
+	}
+	else if( const IECoreScene::CurvesPrimitive *curves = IECore::runTimeCast<const IECoreScene::CurvesPrimitive>( primitive ) )
+	{
+		result = new IECoreScene::CurvesPrimitive( curves->verticesPerCurve(), curves->basis(), curves->periodic() );
+	}
+	else if( const IECoreScene::PointsPrimitive *points = IECore::runTimeCast<const IECoreScene::PointsPrimitive>( primitive ) )
+	{
+		result = new IECoreScene::PointsPrimitive( points->getNumPoints() );
+	}
+	else
+	{
+		return nullptr;
+	}
+
+	result->variables = primitive->variables;
+	return result;
+}
+
+// Extrapolates deformation samples for `object` at `times`, relative to the
+// frame, from its "velocity" (or "v") and optional "accel" primitive
+// variables. Velocities are in units per frame and are multiplied by `scale`.
+// Returns an empty vector if the object has no usable velocities, in which
+// case it is rendered without deformation blur.
+std::vector<IECore::ConstObjectPtr> velocitySamples( const IECore::Object *object, const std::vector<float> &times, float scale )
+{
+	std::vector<IECore::ConstObjectPtr> result;
+
+	const IECoreScene::Primitive *primitive = IECore::runTimeCast<const IECoreScene::Primitive>( object );
+	if( !primitive || scale == 0.0f || times.size() < 2 )
+	{
+		return result;
+	}
+
+	const IECore::V3fVectorData *p = primitive->variableData<IECore::V3fVectorData>( "P", IECoreScene::PrimitiveVariable::Vertex );
+	if( !p )
+	{
+		return result;
+	}
+
+	const size_t size = p->readable().size();
+	const IECore::V3fVectorData *velocity = vertexVectorData( primitive, "velocity", size );
+	if( !velocity )
+	{
+		velocity = vertexVectorData( primitive, "v", size );
+		if( !velocity )
+		{
+			return result;
+		}
+	}
+	const IECore::V3fVectorData *accel = vertexVectorData( primitive, "accel", size );
+
+	for( float time : times )
+	{
+		if( time == 0.0f )
+		{
+			// The source itself is the sample at the frame, which is
+			// the middle sample for a centred shutter.
+			result.push_back( primitive );
+			continue;
+		}
+
+		IECoreScene::PrimitivePtr sample = shallowCopy( primitive );
+		if( !sample )
+		{
+			return std::vector<IECore::ConstObjectPtr>();
+		}
+
+		IECore::V3fVectorDataPtr newP = new IECore::V3fVectorData;
+		newP->setInterpretation( IECore::GeometricData::Point );
+		std::vector<Imath::V3f> &writable = newP->writable();
+		writable.resize( size );
+
+		const Imath::V3f *source = p->readable().data();
+		const Imath::V3f *v = velocity->readable().data();
+		const Imath::V3f *a = accel ? accel->readable().data() : nullptr;
+		const float dt = time * scale;
+		const float dt2 = 0.5f * dt * dt;
+		tbb::parallel_for(
+			tbb::blocked_range<size_t>( 0, size, 4096 ),
+			[&]( const tbb::blocked_range<size_t> &range )
+			{
+				for( size_t i = range.begin(); i != range.end(); ++i )
+				{
+					writable[i] = source[i] + v[i] * dt;
+					if( a )
+					{
+						writable[i] += a[i] * dt2;
+					}
+				}
+			}
+		);
+
+		sample->variables["P"] = IECoreScene::PrimitiveVariable( IECoreScene::PrimitiveVariable::Vertex, newP );
+		result.push_back( sample );
+	}
+
+	return result;
+}
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////
+// Motion decimation
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// Measures how far an object strays from the path given by linearly
+// interpolating between two of its motion samples. Deformation is measured
+// from "P", and transforms from the corners of the object's bound.
+class MotionError
+{
+
+	public :
+
+		// Transforms are measured at the corners of `bound`, which should be
+		// the bound of the object in object space.
+		MotionError( const std::vector<IECore::ConstObjectPtr> &samples, const std::vector<Imath::M44f> &transforms, const Imath::Box3f &bound )
+			:	m_scale( 1.0f ), m_valid( true )
+		{
+			if( samples.size() > 1 )
+			{
+				for( const IECore::ConstObjectPtr &sample : samples )
+				{
+					const IECoreScene::Primitive *primitive = IECore::runTimeCast<const IECoreScene::Primitive>( sample.get() );
+					const IECore::V3fVectorData *p = primitive ? primitive->variableData<IECore::V3fVectorData>( "P", IECoreScene::PrimitiveVariable::Vertex ) : nullptr;
+					if( !p || ( m_positions.size() && p->readable().size() != m_positions.front()->size() ) )
+					{
+						// Topology changes between samples
+						m_valid = false;
+						return;
+					}
+					m_positions.push_back( &p->readable() );
+				}
+			}
+
+			if( transforms.size() > 1 )
+			{
+				for( const Imath::M44f &transform : transforms )
+				{
+					std::array<Imath::V3f, 8> corners;
+					for( int i = 0; i < 8; ++i )
+					{
+						const Imath::V3f corner(
+							i & 1 ? bound.max.x : bound.min.x,
+							i & 2 ? bound.max.y : bound.min.y,
+							i & 4 ? bound.max.z : bound.min.z
+						);
+						corners[i] = corner * transform;
+					}
+					m_corners.push_back( corners );
+				}
+			}
+
+			// Deformation is measured in object space, so is scaled by
+			// the largest axis of the transform to approximate world space.
+			const Imath::M44f &transform = transforms[transforms.size()/2];
+			m_scale = std::max( {
+				Imath::V3f( transform[0][0], transform[0][1], transform[0][2] ).length(),
+				Imath::V3f( transform[1][0], transform[1][1], transform[1][2] ).length(),
+				Imath::V3f( transform[2][0], transform[2][1], transform[2][2] ).length()
+			} );
+		}
+
+		// False if the samples can't be compared, for instance because
+		// the topology changes between them.
+		bool valid() const
+		{
+			return m_valid;
+		}
+
+		// Returns the world space distance between sample `k` and the linear
+		// interpolation between samples `a` and `b` at `t`.
+		float operator()( size_t k, size_t a, size_t b, float t ) const
+		{
+			float result = 0.0f;
+			if( m_corners.size() )
+			{
+				for( int i = 0; i < 8; ++i )
+				{
+					const Imath::V3f interpolated = m_corners[a][i] + ( m_corners[b][i] - m_corners[a][i] ) * t;
+					result = std::max( result, ( m_corners[k][i] - interpolated ).length() );
+				}
+			}
+
+			if( m_positions.size() )
+			{
+				const Imath::V3f *pk = m_positions[k]->data();
+				const Imath::V3f *pa = m_positions[a]->data();
+				const Imath::V3f *pb = m_positions[b]->data();
+				const float deformation = tbb::parallel_reduce(
+					tbb::blocked_range<size_t>( 0, m_positions[k]->size(), 4096 ),
+					0.0f,
+					[&]( const tbb::blocked_range<size_t> &range, float error )
+					{
+						for( size_t i = range.begin(); i != range.end(); ++i )
+						{
+							const Imath::V3f interpolated = pa[i] + ( pb[i] - pa[i] ) * t;
+							error = std::max( error, ( pk[i] - interpolated ).length2() );
+						}
+						return error;
+					},
+					[]( float x, float y ) { return std::max( x, y ); }
+				);
+				result += std::sqrt( deformation ) * m_scale;
+			}
+
+			return result;
+		}
+
+	private :
+
+		std::vector<const std::vector<Imath::V3f> *> m_positions;
+		std::vector<std::array<Imath::V3f, 8>> m_corners;
+		float m_scale;
+		bool m_valid;
+
+};
+
+// Returns the indices of the motion samples needed to reproduce the motion
+// measured by `error` to within `tolerance`. Cycles spreads motion steps evenly
+// over the shutter, so the samples kept are evenly spaced, and always include
+// the first and last. Returns just `reference` if the object is effectively
+// static.
+std::vector<size_t> motionIndices( const MotionError &error, size_t numSamples, size_t reference, float tolerance )
+{
+	std::vector<size_t> result;
+
+	bool isStatic = true;
+	for( size_t k = 0; k < numSamples && isStatic; ++k )
+	{
+		isStatic = error( k, reference, reference, 0.0f ) <= tolerance;
+	}
+
+	if( isStatic )
+	{
+		result.push_back( reference );
+		return result;
+	}
+
+	const size_t segments = numSamples - 1;
+	size_t stride = segments;
+	for( ; stride > 1; --stride )
+	{
+		if( segments % stride )
+		{
+			continue;
+		}
+
+		bool withinTolerance = true;
+		for( size_t a = 0; a < segments && withinTolerance; a += stride )
+		{
+			for( size_t k = a + 1; k < a + stride && withinTolerance; ++k )
+			{
+				withinTolerance = error( k, a, a + stride, (float)( k - a ) / (float)stride ) <= tolerance;
+			}
+		}
+
+		if( withinTolerance )
+		{
+			break;
+		}
+	}
+
+	for( size_t i = 0; i < numSamples; i += stride )
+	{
+		result.push_back( i );
+	}
+	return result;
+}
+
+template<typename T>
+std::vector<T> selectSamples( const std::vector<T> &samples, const std::vector<size_t> &indices )
+{
+	std::vector<T> result;
+	result.reserve( indices.size() );
+	for( size_t index : indices )
+	{
+		result.push_back( samples[index] );
+	}
+	return result;
+}
+
+} // namespace
+
 //////////////////////////////////////////////////////////////////////////
 // CyclesObject
 //////////////////////////////////////////////////////////////////////////
@@ -2314,35 +3841,176 @@ class CyclesObject : public IECoreScenePreview::Renderer::ObjectInterface
 
 	public :
 
-		CyclesObject( ccl::Session *session, const Instance &instance, const float frame )
-			:	m_session( session ), m_instance( instance ), m_frame( frame ), m_attributes( nullptr )
+		// Translation to Cycles is deferred until `translate()` is called
+		// by `CyclesRenderer::render()`. Until then, transforms and attributes
+		// are stored and then applied once the Cycles nodes exist.
+		CyclesObject( ccl::Session *session, const std::string &name, const std::vector<const IECore::Object *> &samples, const std::vector<float> &times, const int frameIdx, const float frame )
+			:	m_session( session ), m_name( name ), m_times( times ), m_frameIdx( frameIdx ), m_frame( frame ), m_attributes( nullptr ), m_hasPendingTransform( false ), m_numMotionSamples( 0 ), m_motionReference( 0 ), m_motionTolerance( 0.0f ), m_motionIndicesChanged( false )
 		{
+			m_samples.reserve( samples.size() );
+			for( const IECore::Object *sample : samples )
+			{
+				m_samples.push_back( sample );
+			}
 		}
 
 		~CyclesObject() override
 		{
+			if( m_instance )
+			{
+				m_instanceCache->retire( *m_instance );
+			}
+			setAttributes( nullptr );
 		}
 
-		void link( const IECore::InternedString &type, const IECoreScenePreview::Renderer::ConstObjectSetPtr &objects ) override
+		// Used to schedule the most expensive translations first.
+		size_t cost() const
 		{
+			size_t result = 0;
+			for( const IECore::ConstObjectPtr &sample : m_samples )
+			{
+				result += sample->memoryUsage();
+			}
+			return result;
 		}
 
-		void transform( const Imath::M44f &transform ) override
+		// Can be called concurrently with other `translate()` calls.
+		void translate( InstanceCache *instanceCache, const LODCamera &lodCamera, const Imath::V2f &shutter, NodesCreated &objects, NodesCreated &geometry )
 		{
-			ccl::Object *object = m_instance.object();
-			if( !object )
+			if( m_instance )
+			{
 				return;
+			}
 
-			object->set_tfm( SocketAlgo::setTransform( transform ) );
-			if( ccl::Mesh *mesh = (ccl::Mesh*)object->get_geometry() )
+			m_instanceCache = instanceCache;
+			ConstCyclesAttributesPtr attributes = m_attributes;
+			setAttributes( nullptr );
+
+			const float curveDensity = attributes->curveDensity(
+				m_samples.front().get(),
+				m_hasPendingTransform ? m_pendingTransform.front() : Imath::M44f(),
+				lodCamera
+			);
+
+			std::vector<float> times = m_times;
+			int frameIdx = m_frameIdx;
+			if( m_samples.size() == 1 && attributes->velocityScale() != 0.0f )
 			{
-				if( mesh->geometry_type == ccl::Geometry::MESH )
+				// Cycles needs the same number of deformation and transform
+				// steps, so when the object has transform blur the samples
+				// are made at the same times as the transform. Otherwise we
+				// sample the start, middle and end of the shutter, and the
+				// middle sample is the reference.
+				std::vector<float> sampleTimes;
+				int sampleFrameIdx = -1;
+				if( m_hasPendingTransform && m_pendingTransformTimes.size() > 1 )
 				{
-					if( ccl::SubdParams *params = mesh->get_subd_params() )
-						mesh->set_subd_objecttoworld( object->get_tfm() );
+					sampleTimes = m_pendingTransformTimes;
+					if( shutter[0] == 0.0f )
+					{
+						sampleFrameIdx = 0;
+					}
+					else if( shutter[1] == 0.0f )
+					{
+						sampleFrameIdx = sampleTimes.size() - 1;
+					}
+				}
+				else if( shutter[0] < shutter[1] )
+				{
+					sampleTimes = { m_frame + shutter[0], m_frame + ( shutter[0] + shutter[1] ) * 0.5f, m_frame + shutter[1] };
+				}
+
+				std::vector<float> offsets;
+				for( float time : sampleTimes )
+				{
+					offsets.push_back( time - m_frame );
+				}
+
+				std::vector<IECore::ConstObjectPtr> samples = velocitySamples( m_samples.front().get(), offsets, attributes->velocityScale() );
+				if( samples.size() )
+				{
+					m_samples = samples;
+					times = sampleTimes;
+					frameIdx = sampleFrameIdx;
+				}
+			}
+
+			const float motionTolerance = attributes->motionTolerance(
+				m_samples.front().get(),
+				m_hasPendingTransform ? m_pendingTransform.front() : Imath::M44f(),
+				lodCamera
+			);
+			if( motionTolerance > 0.0f )
+			{
+				decimateMotion( motionTolerance, times, frameIdx );
+			}
+
+			if( m_samples.size() == 1 )
+			{
+				m_instance = instanceCache->get( m_samples.front().get(), attributes.get(), m_name, curveDensity );
+			}
+			else
+			{
+				std::vector<const IECore::Object *> samples;
+				samples.reserve( m_samples.size() );
+				for( const IECore::ConstObjectPtr &sample : m_samples )
+				{
+					samples.push_back( sample.get() );
 				}
+				m_instance = instanceCache->get( samples, times, frameIdx, attributes.get(), m_name, curveDensity );
 			}
 
+			// The source objects are no longer needed.
+			m_samples.clear();
+
+			if( !this->attributes( attributes.get() ) )
+			{
+				// Reported by `translatePendingObjects()`. The object isn't
+				// added to the scene.
+				throw IECore::Exception( boost::str( boost::format( "Unable to apply attributes to \"%s\"" ) % m_name ) );
+			}
+
+			if( m_hasPendingTransform )
+			{
+				if( m_pendingTransformTimes.empty() )
+				{
+					transform( m_pendingTransform.front() );
+				}
+				else
+				{
+					transform( m_pendingTransform, m_pendingTransformTimes );
+				}
+				m_pendingTransform.clear();
+				m_pendingTransformTimes.clear();
+				m_hasPendingTransform = false;
+			}
+
+			m_instance->objectsCreated( objects );
+			// These will only accumulate if it's the prototype
+			m_instance->geometryCreated( geometry );
+		}
+
+		void link( const IECore::InternedString &type, const IECoreScenePreview::Renderer::ConstObjectSetPtr &objects ) override
+		{
+		}
+
+		void transform( const Imath::M44f &transform ) override
+		{
+			if( !m_instance )
+			{
+				m_pendingTransform.assign( 1, transform );
+				m_pendingTransformTimes.clear();
+				m_hasPendingTransform = true;
+				return;
+			}
+
+			ccl::Object *object = m_instance->object();
+			if( !object )
+				return;
+
+			object->set_tfm( SocketAlgo::setTransform( transform ) );
+			updateSubdivisionTransform();
+
 			ccl::array<ccl::Transform> motion;
 			if( object->get_geometry()->get_use_motion_blur() )
 			{
@@ -2360,7 +4028,26 @@ class CyclesObject : public IECoreScenePreview::Renderer::ObjectInterface
 
 		void transform( const std::vector<Imath::M44f> &samples, const std::vector<float> &times ) override
 		{
-			ccl::Object *object = m_instance.object();
+			if( !m_instance )
+			{
+				m_pendingTransform = samples;
+				m_pendingTransformTimes = times;
+				m_hasPendingTransform = true;
+				return;
+			}
+
+			if( m_motionIndices.size() && samples.size() == m_numMotionSamples )
+			{
+				updateMotionIndices( samples );
+				if( m_motionIndices.size() != samples.size() )
+				{
+					// Match the motion steps chosen by `decimateMotion()`.
+					transform( selectSamples( samples, m_motionIndices ), selectSamples( times, m_motionIndices ) );
+					return;
+				}
+			}
+
+			ccl::Object *object = m_instance->object();
 			if( !object )
 				return;
 
@@ -2466,14 +4153,7 @@ class CyclesObject : public IECoreScenePreview::Renderer::ObjectInterface
 				geo->set_motion_steps( motion.size() );
 			}
 
-			if( ccl::Mesh *mesh = (ccl::Mesh*)object->get_geometry() )
-			{
-				if( mesh->geometry_type == ccl::Geometry::MESH )
-				{
-					if( ccl::SubdParams *params = mesh->get_subd_params() )
-						mesh->set_subd_objecttoworld( object->get_tfm() );
-				}
-			}
+			updateSubdivisionTransform();
 
 			object->tag_update( m_session->scene );
 		}
@@ -2482,10 +4162,37 @@ class CyclesObject : public IECoreScenePreview::Renderer::ObjectInterface
 		{
 			const CyclesAttributes *cyclesAttributes = static_cast<const CyclesAttributes *>( attributes );
 
-			ccl::Object *object = m_instance.object();
+			if( !m_instance )
+			{
+				// Applied in `translate()`.
+				setAttributes( cyclesAttributes );
+				return true;
+			}
+
+			if( m_motionIndicesChanged )
+			{
+				// A transform edit needs different motion steps from those
+				// the geometry was converted with. Re-issue, so that both
+				// are decimated again.
+				return false;
+			}
+
+			if(
+				m_attributes && !m_instance->uniqueGeometry() &&
+				cyclesAttributes->shaderHash() != m_attributes->shaderHash() &&
+				!cyclesAttributes->shaderEditedInPlace( m_attributes.get() )
+			)
+			{
+				// The geometry is shared with other objects, and
+				// assigning new shaders to it would affect them too.
+				// Re-issue, so we get geometry matching our shaders.
+				return false;
+			}
+
+			ccl::Object *object = m_instance->object();
 			if( !object || cyclesAttributes->applyObject( object, m_attributes.get() ) )
 			{
-				m_attributes = cyclesAttributes;
+				setAttributes( cyclesAttributes );
 				object->tag_update( m_session->scene );
 				return true;
 			}
@@ -2495,15 +4202,276 @@ class CyclesObject : public IECoreScenePreview::Renderer::ObjectInterface
 
 	private :
 
+		void setAttributes( const CyclesAttributes *attributes )
+		{
+			if( attributes )
+			{
+				attributes->objectAdded();
+			}
+			if( m_attributes )
+			{
+				m_attributes->objectRemoved();
+			}
+			m_attributes = attributes;
+		}
+
+		// Drops the deformation and transform samples that can be reproduced
+		// to within `tolerance` by interpolating between the others. Both
+		// are decimated together, because Cycles needs the same number of
+		// steps for each.
+		void decimateMotion( float tolerance, std::vector<float> &times, int &frameIdx )
+		{
+			const std::vector<Imath::M44f> transforms = m_hasPendingTransform ? m_pendingTransform : std::vector<Imath::M44f>( 1 );
+			const size_t numSamples = std::max( m_samples.size(), transforms.size() );
+			if(
+				numSamples < 2 ||
+				( m_samples.size() > 1 && m_samples.size() != numSamples ) ||
+				( transforms.size() > 1 && transforms.size() != numSamples )
+			)
+			{
+				return;
+			}
+
+			const IECoreScene::Primitive *primitive = IECore::runTimeCast<const IECoreScene::Primitive>( m_samples.front().get() );
+			const Imath::Box3f bound = primitive ? primitive->bound() : Imath::Box3f( Imath::V3f( 0.0f ) );
+			const MotionError error( m_samples, transforms, bound );
+			if( !error.valid() )
+			{
+				return;
+			}
+
+			const std::vector<float> &sampleTimes = m_samples.size() > 1 ? times : m_pendingTransformTimes;
+			size_t reference = numSamples / 2;
+			for( size_t i = 0; i < sampleTimes.size(); ++i )
+			{
+				if( sampleTimes[i] == m_frame )
+				{
+					reference = i;
+				}
+			}
+
+			const std::vector<size_t> indices = motionIndices( error, numSamples, reference, tolerance );
+			if( indices.size() == numSamples )
+			{
+				return;
+			}
+
+			// Kept so that the motion can be measured again if the transform
+			// is edited. The deformation samples are only needed when they
+			// are being decimated.
+			m_motionBound = bound;
+			m_motionReference = reference;
+			m_motionTolerance = tolerance;
+			if( m_samples.size() > 1 )
+			{
+				m_motionSamples = m_samples;
+			}
+
+			if( m_samples.size() > 1 )
+			{
+				m_samples = selectSamples( m_samples, indices );
+				times = selectSamples( times, indices );
+				if( frameIdx > 0 )
+				{
+					frameIdx = indices.size() - 1;
+				}
+			}
+
+			if( transforms.size() > 1 )
+			{
+				m_pendingTransform = selectSamples( m_pendingTransform, indices );
+				m_pendingTransformTimes = selectSamples( m_pendingTransformTimes, indices );
+			}
+
+			m_motionIndices = indices;
+			m_numMotionSamples = numSamples;
+		}
+
+		// The steps kept by `decimateMotion()` were chosen for the transform
+		// at the time, so are measured again whenever it is edited.
+		void updateMotionIndices( const std::vector<Imath::M44f> &transforms )
+		{
+			const MotionError error( m_motionSamples, transforms, m_motionBound );
+			if( !error.valid() )
+			{
+				return;
+			}
+
+			const std::vector<size_t> indices = motionIndices( error, m_numMotionSamples, m_motionReference, m_motionTolerance );
+			if( indices == m_motionIndices )
+			{
+				return;
+			}
+
+			if( m_motionSamples.size() > 1 )
+			{
+				// The geometry was converted with deformation steps matching
+				// the previous indices, and Cycles needs the same number of
+				// transform steps. Keep those until `attributes()` re-issues
+				// the object.
+				m_motionIndicesChanged = true;
+				return;
+			}
+
+			m_motionIndices = indices;
+		}
+
+		void updateSubdivisionTransform()
+		{
+			ccl::Object *object = m_instance->object();
+			if( ccl::Mesh *mesh = (ccl::Mesh*)object->get_geometry() )
+			{
+				if( mesh->geometry_type == ccl::Geometry::MESH )
+				{
+					if( ccl::SubdParams *params = mesh->get_subd_params() )
+					{
+						if( m_instance->uniqueGeometry() )
+						{
+							mesh->set_subd_objecttoworld( object->get_tfm() );
+						}
+						else
+						{
+							// Shared between instances, so the dicing transform
+							// is chosen by the cache.
+							m_instanceCache->subdivisionInstanceMoved();
+						}
+					}
+				}
+			}
+		}
+
 		ccl::Session *m_session;
-		Instance m_instance;
+		const std::string m_name;
+		std::vector<IECore::ConstObjectPtr> m_samples;
+		const std::vector<float> m_times;
+		const int m_frameIdx;
+		boost::optional<Instance> m_instance;
+		// Held so that `m_instance` can be retired even after the
+		// renderer has reset its caches.
+		InstanceCachePtr m_instanceCache;
 		const float m_frame;
 		ConstCyclesAttributesPtr m_attributes;
+		bool m_hasPendingTransform;
+		std::vector<Imath::M44f> m_pendingTransform;
+		std::vector<float> m_pendingTransformTimes;
+		// The motion samples kept by `decimateMotion()`, and what
+		// is needed to choose them again in `updateMotionIndices()`.
+		std::vector<size_t> m_motionIndices;
+		size_t m_numMotionSamples;
+		std::vector<IECore::ConstObjectPtr> m_motionSamples;
+		Imath::Box3f m_motionBound;
+		size_t m_motionReference;
+		float m_motionTolerance;
+		bool m_motionIndicesChanged;
+
+};
+
+IE_CORE_DECLAREPTR( CyclesObject )
+
+} // namespace
+
+#ifdef WITH_ALEMBIC
+
+//////////////////////////////////////////////////////////////////////////
+// CyclesProcedural
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+
+// Keeps an Alembic procedural alive for as long as Gaffer holds the object.
+// Cycles takes the transforms from the file, so the location's own
+// transform can't be applied.
+class CyclesProcedural : public IECoreScenePreview::Renderer::ObjectInterface
+{
+
+	public :
+
+		CyclesProcedural( const std::string &name, const AlembicProceduralDataPtr &procedural )
+			:	m_name( name ), m_procedural( procedural )
+		{
+		}
+
+		void link( const IECore::InternedString &type, const IECoreScenePreview::Renderer::ConstObjectSetPtr &objects ) override
+		{
+		}
+
+		void transform( const Imath::M44f &transform ) override
+		{
+			if( transform != Imath::M44f() )
+			{
+				IECore::msg( IECore::Msg::Warning, "CyclesRenderer", boost::format( "Ignoring transform on Alembic procedural \"%s\"." ) % m_name );
+			}
+		}
+
+		void transform( const std::vector<Imath::M44f> &samples, const std::vector<float> &times ) override
+		{
+			transform( samples.front() );
+		}
+
+		bool attributes( const IECoreScenePreview::Renderer::AttributesInterface *attributes ) override
+		{
+			// The shader is assigned when the procedural is made, so
+			// request a new object.
+			return false;
+		}
+
+	private :
+
+		const std::string m_name;
+		AlembicProceduralDataPtr m_procedural;
 
 };
 
+IE_CORE_DECLAREPTR( CyclesProcedural )
+
+float numericParameter( const IECore::CompoundData *parameters, const IECore::InternedString &name, float defaultValue )
+{
+	const IECore::Data *data = parameters->member<IECore::Data>( name );
+	if( !data )
+	{
+		return defaultValue;
+	}
+
+	switch( data->typeId() )
+	{
+		case IECore::FloatDataTypeId :
+			return static_cast<const IECore::FloatData *>( data )->readable();
+		case IECore::DoubleDataTypeId :
+			return static_cast<const IECore::DoubleData *>( data )->readable();
+		case IECore::IntDataTypeId :
+			return static_cast<const IECore::IntData *>( data )->readable();
+		default :
+			IECore::msg( IECore::Msg::Warning, "CyclesRenderer", boost::format( "Alembic procedural parameter \"%s\" has unsupported type \"%s\"." ) % name.string() % data->typeName() );
+			return defaultValue;
+	}
+}
+
+// Appends the full names of the shapes below `object` that Cycles can
+// render. These are the names the AlembicProcedural matches objects
+// against, and include the shape itself, as in "/a/b/bShape".
+void alembicObjectPaths( const Alembic::Abc::IObject &object, std::vector<std::string> &paths )
+{
+	for( size_t i = 0, e = object.getNumChildren(); i < e; ++i )
+	{
+		const Alembic::Abc::ObjectHeader &header = object.getChildHeader( i );
+		if(
+			Alembic::AbcGeom::IPolyMesh::matches( header ) ||
+			Alembic::AbcGeom::ISubD::matches( header ) ||
+			Alembic::AbcGeom::ICurves::matches( header ) ||
+			Alembic::AbcGeom::IPoints::matches( header )
+		)
+		{
+			paths.push_back( header.getFullName() );
+		}
+		alembicObjectPaths( object.getChild( i ), paths );
+	}
+}
+
 } // namespace
 
+#endif // WITH_ALEMBIC
+
 //////////////////////////////////////////////////////////////////////////
 // CyclesLight
 //////////////////////////////////////////////////////////////////////////
@@ -2516,13 +4484,14 @@ class CyclesLight : public IECoreScenePreview::Renderer::ObjectInterface
 
 	public :
 
-		CyclesLight( ccl::Session *session, SharedCLightPtr &light )
-			: m_session( session ), m_light( light ), m_attributes( nullptr )
+		CyclesLight( ccl::Session *session, SharedCLightPtr &light, LightCachePtr lightCache )
+			: m_session( session ), m_light( light ), m_attributes( nullptr ), m_lightCache( lightCache )
 		{
 		}
 
 		~CyclesLight() override
 		{
+			m_lightCache->retire( m_light );
 		}
 
 		void link( const IECore::InternedString &type, const IECoreScenePreview::Renderer::ConstObjectSetPtr &objects ) override
@@ -2576,6 +4545,7 @@ class CyclesLight : public IECoreScenePreview::Renderer::ObjectInterface
 		ccl::Session *m_session;
 		SharedCLightPtr m_light;
 		ConstCyclesAttributesPtr m_attributes;
+		LightCachePtr m_lightCache;
 
 };
 
@@ -2911,7 +4881,10 @@ class CyclesRenderer final : public IECoreScenePreview::Renderer
 			m_shaderCache = new ShaderCache( m_scene );
 			m_particleSystemsCache = new ParticleSystemsCache( m_scene );
 			m_instanceCache = new InstanceCache( m_scene, m_particleSystemsCache );
-			m_attributesCache = new AttributesCache( m_shaderCache );
+			m_attributesCache = new AttributesCache( m_shaderCache, m_particleSystemsCache );
+#ifdef WITH_ALEMBIC
+			m_proceduralCache = new ProceduralCache( m_scene );
+#endif
 
 		}
 
@@ -3456,7 +5429,7 @@ class CyclesRenderer final : public IECoreScenePreview::Renderer
 				return nullptr;
 			}
 
-			CyclesLightPtr result = new CyclesLight( m_session, clight );
+			CyclesLightPtr result = new CyclesLight( m_session, clight, m_lightCache );
 			result->attributes( attributes );
 
 			result->nodesCreated( m_lightsCreated );
@@ -3481,15 +5454,20 @@ class CyclesRenderer final : public IECoreScenePreview::Renderer
 				return nullptr;
 			}
 
-			Instance instance = m_instanceCache->get( object, attributes, name );
+#ifdef WITH_ALEMBIC
+			if( const IECoreScene::ExternalProcedural *procedural = IECore::runTimeCast<const IECoreScene::ExternalProcedural>( object ) )
+			{
+				if( boost::ends_with( procedural->getFileName(), ".abc" ) )
+				{
+					return alembicProcedural( name, procedural, attributes );
+				}
+			}
+#endif
 
-			ObjectInterfacePtr result = new CyclesObject( m_session, instance, m_frame );
+			// Translation is deferred to `translatePendingObjects()`.
+			CyclesObjectPtr result = new CyclesObject( m_session, name, { object }, {}, -1, m_frame );
 			result->attributes( attributes );
-
-			instance.objectsCreated( m_objectsCreated );
-			// These will only accumulate if it's the prototype
-			instance.geometryCreated( m_geometryCreated );
-			instance.particleSystemsCreated( m_particleSystemsCreated );
+			m_objectsPending.push_back( result );
 
 			return result;
 		}
@@ -3503,6 +5481,14 @@ class CyclesRenderer final : public IECoreScenePreview::Renderer
 				return nullptr;
 			}
 
+#ifdef WITH_ALEMBIC
+			if( samples.front()->typeId() == IECoreScene::ExternalProceduralTypeId )
+			{
+				// Motion comes from the file.
+				return object( name, samples.front(), attributes );
+			}
+#endif
+
 			int frameIdx = -1;
 			if( m_scene->camera->get_motion_position() == ccl::Camera::MOTION_POSITION_START )
 			{
@@ -3512,23 +5498,69 @@ class CyclesRenderer final : public IECoreScenePreview::Renderer
 			{
 				frameIdx = times.size()-1;
 			}
-			Instance instance = m_instanceCache->get( samples, times, frameIdx, attributes, name );
 
-			ObjectInterfacePtr result = new CyclesObject( m_session, instance, m_frame );
+			// Translation is deferred to `translatePendingObjects()`.
+			CyclesObjectPtr result = new CyclesObject( m_session, name, samples, times, frameIdx, m_frame );
 			result->attributes( attributes );
-
-			instance.objectsCreated( m_objectsCreated );
-			// These will only accumulate if it's the prototype
-			instance.geometryCreated( m_geometryCreated );
-			instance.particleSystemsCreated( m_particleSystemsCreated );
+			m_objectsPending.push_back( result );
 
 			return result;
 		}
 
+#ifdef WITH_ALEMBIC
+		// Maps ExternalProcedurals referencing Alembic files onto Cycles'
+		// own procedural, so that the file is read by Cycles at render time
+		// rather than being expanded into the Gaffer scene first. Objects
+		// may be listed with an "objectPaths" parameter, giving the full
+		// Alembic names of the shapes (including the shape node itself, as in
+		// "/a/b/bShape"), and otherwise every shape in the file is rendered.
+		ObjectInterfacePtr alembicProcedural( const std::string &name, const IECoreScene::ExternalProcedural *procedural, const AttributesInterface *attributes )
+		{
+			const IECore::CompoundData *parameters = procedural->parameters();
+
+			AlembicProceduralDataPtr data = new AlembicProceduralData;
+			data->fileName = procedural->getFileName();
+			data->frame = numericParameter( parameters, "frame", m_frame );
+			data->frameRate = numericParameter( parameters, "fps", data->frameRate );
+			data->scale = numericParameter( parameters, "scale", data->scale );
+			data->shader = static_cast<const CyclesAttributes *>( attributes )->shader();
+
+			if( const IECore::StringVectorData *objectPaths = parameters->member<IECore::StringVectorData>( "objectPaths" ) )
+			{
+				data->objectPaths = objectPaths->readable();
+			}
+			else
+			{
+				try
+				{
+					Alembic::AbcCoreFactory::IFactory factory;
+					Alembic::Abc::IArchive archive = factory.getArchive( data->fileName );
+					if( !archive.valid() )
+					{
+						throw IECore::Exception( "Not a valid Alembic archive" );
+					}
+					alembicObjectPaths( archive.getTop(), data->objectPaths );
+				}
+				catch( const std::exception &e )
+				{
+					IECore::msg( IECore::Msg::Error, "CyclesRenderer", boost::format( "Unable to read Alembic procedural \"%s\" : %s" ) % name % e.what() );
+					return nullptr;
+				}
+			}
+
+			m_proceduralCache->add( data );
+			return new CyclesProcedural( name, data );
+		}
+#endif
+
 		void render() override
 		{
 			const IECore::MessageHandler::Scope s( m_messageHandler.get() );
 
+			// Convert everything queued by `object()` before we block the
+			// render threads by taking the scene lock.
+			translatePendingObjects();
+
 			m_scene->mutex.lock();
 			{
 				if( m_renderState == RENDERSTATE_RENDERING && m_renderType == Interactive )
@@ -3539,6 +5571,7 @@ class CyclesRenderer final : public IECoreScenePreview::Renderer
 				updateSceneObjects();
 				updateOptions();
 				updateCamera();
+				m_instanceCache->updateSubdivisionInstances( m_scene->dicing_camera );
 				updateOutputs();
 
 				if( m_renderState == RENDERSTATE_RENDERING )
@@ -3677,6 +5710,127 @@ class CyclesRenderer final : public IECoreScenePreview::Renderer
 			m_scene->film->set_exposure( 1.0f );
 		}
 
+		// The shutter of the render camera relative to the frame, as used to
+		// synthesise deformation blur from velocities. This is taken from the
+		// converted camera so that it matches the motion position used by Cycles.
+		Imath::V2f shutter()
+		{
+			const auto cameraIt = m_cameras.find( m_camera );
+			if( cameraIt == m_cameras.end() )
+			{
+				return Imath::V2f( 0.0f );
+			}
+
+			SharedCCameraPtr ccamera = m_cameraCache->get( cameraIt->second.get(), m_camera );
+			if( !ccamera )
+			{
+				return Imath::V2f( 0.0f );
+			}
+
+			const float shutterTime = ccamera->get_shuttertime();
+			switch( ccamera->get_motion_position() )
+			{
+				case ccl::Camera::MOTION_POSITION_START :
+					return Imath::V2f( 0.0f, shutterTime );
+				case ccl::Camera::MOTION_POSITION_END :
+					return Imath::V2f( -shutterTime, 0.0f );
+				default :
+					return Imath::V2f( -shutterTime * 0.5f, shutterTime * 0.5f );
+			}
+		}
+
+		// Curve density is chosen when objects are translated, so only
+		// the camera at that time is taken into account.
+		LODCamera lodCamera()
+		{
+			LODCamera result;
+
+			const auto cameraIt = m_cameras.find( m_camera );
+			if( cameraIt == m_cameras.end() )
+			{
+				return result;
+			}
+
+			SharedCCameraPtr ccamera = m_cameraCache->get( cameraIt->second.get(), m_camera );
+			if( !ccamera )
+			{
+				return result;
+			}
+
+			const ccl::CameraType type = ccamera->get_camera_type();
+			const float width = ccamera->get_viewplane_right() - ccamera->get_viewplane_left();
+			if( ( type != ccl::CAMERA_PERSPECTIVE && type != ccl::CAMERA_ORTHOGRAPHIC ) || width <= 0.0f )
+			{
+				return result;
+			}
+
+			// Cameras are converted with a 90 degree field of view, so the
+			// viewplane is the size of the image at unit distance.
+			const ccl::Transform matrix = ccamera->get_matrix();
+			const ccl::float3 position = ccl::transform_get_column( &matrix, 3 );
+			result.valid = true;
+			result.orthographic = type == ccl::CAMERA_ORTHOGRAPHIC;
+			result.position = Imath::V3f( position.x, position.y, position.z );
+			result.pixelsPerUnit = (float)ccamera->get_full_width() / width;
+			return result;
+		}
+
+		void translatePendingObjects()
+		{
+			if( m_objectsPending.empty() )
+			{
+				return;
+			}
+
+			// Schedule the largest objects first, so that a few expensive
+			// conversions don't end up running alone at the end of the queue.
+			// In interactive renders, objects that Gaffer has already released
+			// are skipped entirely. Batch renders release every object as soon
+			// as it is created, so all must be translated.
+			std::vector<std::pair<size_t, CyclesObject *>> queue;
+			queue.reserve( m_objectsPending.size() );
+			for( const CyclesObjectPtr &object : m_objectsPending )
+			{
+				if( m_renderType != Interactive || object->refCount() > 1 )
+				{
+					queue.push_back( std::make_pair( object->cost(), object.get() ) );
+				}
+			}
+			std::stable_sort(
+				queue.begin(), queue.end(),
+				[]( const std::pair<size_t, CyclesObject *> &a, const std::pair<size_t, CyclesObject *> &b ) { return a.first > b.first; }
+			);
+
+			const LODCamera lodCamera = this->lodCamera();
+			const Imath::V2f shutter = this->shutter();
+
+			std::atomic<size_t> next( 0 );
+			IECore::MessageHandler *messageHandler = m_messageHandler.get();
+			tbb::task_group taskGroup;
+			for( int i = 0, numWorkers = tbb::this_task_arena::max_concurrency(); i < numWorkers; ++i )
+			{
+				taskGroup.run(
+					[&]() {
+						const IECore::MessageHandler::Scope s( messageHandler );
+						for( size_t index = next++; index < queue.size(); index = next++ )
+						{
+							try
+							{
+								queue[index].second->translate( m_instanceCache.get(), lodCamera, shutter, m_objectsCreated, m_geometryCreated );
+							}
+							catch( const std::exception &e )
+							{
+								IECore::msg( IECore::Msg::Error, "CyclesRenderer", e.what() );
+							}
+						}
+					}
+				);
+			}
+			taskGroup.wait();
+
+			m_objectsPending.clear();
+		}
+
 		void clearUnused()
 		{
 			m_cameraCache->clearUnused();
@@ -3684,6 +5838,9 @@ class CyclesRenderer final : public IECoreScenePreview::Renderer
 			m_particleSystemsCache->clearUnused();
 			m_lightCache->clearUnused();
 			m_attributesCache->clearUnused();
+#ifdef WITH_ALEMBIC
+			m_proceduralCache->clearUnused();
+#endif
 		}
 
 		void updateSceneObjects( bool newScene = false )
@@ -3694,15 +5851,16 @@ class CyclesRenderer final : public IECoreScenePreview::Renderer
 				m_instanceCache->nodesCreated( m_objectsCreated, m_geometryCreated );
 				m_lightCache->nodesCreated( m_lightsCreated );
 				m_particleSystemsCache->nodesCreated( m_particleSystemsCreated );
+				m_shaderCache->nodesCreated( m_shadersCreated );
 			}
 
-			// Add every shader each time, less issues
-			m_shaderCache->nodesCreated( m_shadersCreated );
-
 			m_lightCache->update( m_scene, m_lightsCreated );
 			m_particleSystemsCache->update( m_scene, m_particleSystemsCreated );
 			m_instanceCache->update( m_scene, m_objectsCreated, m_geometryCreated );
 			m_shaderCache->update( m_scene, m_shadersCreated );
+#ifdef WITH_ALEMBIC
+			m_proceduralCache->update( m_scene, m_renderType == Interactive );
+#endif
 		}
 
 		void updateOptions()
@@ -4010,6 +6168,11 @@ class CyclesRenderer final : public IECoreScenePreview::Renderer
 		{
 			m_session->cancel();
 			m_renderState = RENDERSTATE_READY;
+#ifdef WITH_ALEMBIC
+			// Procedurals delete the objects they generated, which must
+			// happen before the objects are removed from the scene below.
+			m_proceduralCache->clearNodes();
+#endif
 			// This is so cycles doesn't delete the objects that Gaffer manages.
 			m_scene->objects.clear();
 			m_scene->geometry.clear();
@@ -4133,6 +6296,10 @@ class CyclesRenderer final : public IECoreScenePreview::Renderer
 				status += ": " + subStatus;
 
 			memStatus = ccl::string_printf( "Mem:%.3fG, Peak:%.3fG", (double)memUsed, (double)memPeak );
+			if( const size_t colorBytesSaved = m_instanceCache->colorBytesSaved() )
+			{
+				memStatus += ccl::string_printf( ", Byte colours saved:%.3fG", (double)colorBytesSaved / 1024.0 / 1024.0 / 1024.0 );
+			}
 
 			double currentTime = ccl::time_dt();
 			if( status != m_lastStatus )// || ( m_renderType == Interactive && ( currentTime - m_lastStatusTime ) > 1.0 ) )
@@ -4269,6 +6436,12 @@ class CyclesRenderer final : public IECoreScenePreview::Renderer
 		InstanceCachePtr m_instanceCache;
 		ParticleSystemsCachePtr m_particleSystemsCache;
 		AttributesCachePtr m_attributesCache;
+#ifdef WITH_ALEMBIC
+		ProceduralCachePtr m_proceduralCache;
+#endif
+
+		// Objects waiting to be translated by `translatePendingObjects()`
+		tbb::concurrent_vector<CyclesObjectPtr> m_objectsPending;
 
 		// Nodes created to update to Cycles
 		NodesCreated m_objectsCreated;
@@ -34,6 +34,8 @@
 
 #include "GafferCycles/IECoreCyclesPreview/SocketAlgo.h"
 
+#include "PackingAlgo.h"
+
 #include "IECore/SimpleTypedData.h"
 #include "IECore/VectorTypedData.h"
 
@@ -60,18 +62,33 @@ void convert( ccl::Node *node, const ccl::SocketType *socket, const IECore::Data
 	}
 }
 
+// Only valid for types with the same layout in Cortex and Cycles.
 template<typename T, typename U>
 void dataToArray( ccl::Node *node, const ccl::SocketType *socket, const IECore::Data *value )
 {
 	if( const U *data = static_cast<const U *>( value ) )
 	{
 		const auto &vector = data->readable();
+		static_assert( sizeof( T ) == sizeof( vector[0] ), "Mismatched layout" );
 		ccl::array<T> array( vector.size() );
 		memcpy((void*)array.data(), &vector[0], vector.size() * sizeof(T) );
 		node->set( *socket, array );
 	}
 }
 
+// For vectors and colours, which are padded to four floats in Cycles.
+template<typename U>
+void dataToFloat3Array( ccl::Node *node, const ccl::SocketType *socket, const IECore::Data *value )
+{
+	if( const U *data = static_cast<const U *>( value ) )
+	{
+		const auto &vector = data->readable();
+		ccl::array<ccl::float3> array( vector.size() );
+		PackingAlgo::pack( vector.data(), array.data(), vector.size() );
+		node->set( *socket, array );
+	}
+}
+
 template<typename T, typename U>
 IECore::DataPtr arrayToData( const ccl::array<U>& array )
 {
@@ -321,15 +338,16 @@ void setSocket( ccl::Node *node, const ccl::SocketType *socket, const IECore::Da
 			dataToArray<int, IntVectorData>( node, socket, value );
 			break;
 		case ccl::SocketType::COLOR_ARRAY:
-			dataToArray<ccl::float3, Color3fVectorData>( node, socket, value );
+			dataToFloat3Array<Color3fVectorData>( node, socket, value );
 			break;
 		case ccl::SocketType::VECTOR_ARRAY:
 		case ccl::SocketType::POINT_ARRAY:
 		case ccl::SocketType::NORMAL_ARRAY:
-			dataToArray<ccl::float3, V3fVectorData>( node, socket, value );
+			dataToFloat3Array<V3fVectorData>( node, socket, value );
 			break;
 		case ccl::SocketType::POINT2_ARRAY:
 			dataToArray<ccl::float2, V2fVectorData>( node, socket, value );
+			break;
 		case ccl::SocketType::STRING_ARRAY:
 			if( const StringVectorData *data = static_cast<const StringVectorData *>( value ) )
 			{